@@ -0,0 +1,239 @@
+// 模拟器热点路径的微基准
+// 运行：sim_bench --benchmark_out=result.json --benchmark_out_format=json
+
+#include "../include/cpu_state.h"
+#include "../include/instruction.h"
+#include "../include/memory_access.h"
+#include "../include/process.h"
+#include "../include/riscv_simulator.h"
+#include "../include/stream_generator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// 合成指令流：循环次数足够大，基准运行期间不会停机
+
+static StreamConfig mix_config(double alu, double branch, double load, double store) {
+    StreamConfig config;
+    config.iterations = 1u << 30;
+    config.alu_weight = alu;
+    config.branch_weight = branch;
+    config.load_weight = load;
+    config.store_weight = store;
+    return config;
+}
+
+static void write_program(CPU_State &cpu, const GeneratedStream &stream) {
+    for (size_t i = 0; i < stream.code.size(); ++i) {
+        MemoryAccess::write(cpu.memory, static_cast<uint32_t>(i * 4), 4, stream.code[i]);
+    }
+    for (size_t i = 0; i < stream.data.size(); ++i) {
+        MemoryAccess::write(cpu.memory, stream.data_base + static_cast<uint32_t>(i * 4), 4,
+                            stream.data[i]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 单个函数
+
+static void BM_Decode(benchmark::State &state) {
+    const std::vector<uint32_t> encodings = StreamGenerator::generate(StreamConfig(), false).code;
+    size_t i = 0;
+    for (auto _ : state) {
+        Instruction instr = InstructionProcessor::decode(encodings[i], static_cast<uint32_t>(i * 4));
+        benchmark::DoNotOptimize(instr);
+        i = i + 1 == encodings.size() ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Decode);
+
+static void BM_DecodeCompressed(benchmark::State &state) {
+    // c.addi, c.lw, c.sw, c.j, c.beqz, c.mv, c.add, c.li
+    const uint16_t encodings[] = {0x0505, 0x4398, 0xC398, 0xBFF5, 0xC111, 0x852E, 0x952E, 0x4501};
+    const size_t count = sizeof(encodings) / sizeof(encodings[0]);
+    size_t i = 0;
+    for (auto _ : state) {
+        Instruction instr = InstructionProcessor::decode(encodings[i], 0);
+        benchmark::DoNotOptimize(instr);
+        i = i + 1 == count ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DecodeCompressed);
+
+static void BM_ExecuteAlu(benchmark::State &state) {
+    const InstrType ops[] = {InstrType::ALU_ADD,  InstrType::ALU_SUB,  InstrType::ALU_XOR,
+                             InstrType::ALU_SLL,  InstrType::ALU_SRA,  InstrType::ALU_SLTU,
+                             InstrType::ALU_ADDI, InstrType::ALU_ANDI, InstrType::ALU_SRLI,
+                             InstrType::LUI};
+    const size_t count = sizeof(ops) / sizeof(ops[0]);
+    uint32_t value = 0x12345678;
+    size_t i = 0;
+    for (auto _ : state) {
+        value = InstructionProcessor::execute_alu(ops[i], value, value >> 3, 5) | 1;
+        benchmark::DoNotOptimize(value);
+        i = i + 1 == count ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ExecuteAlu);
+
+// ---------------------------------------------------------------------------
+// 流水线：每次迭代为一个周期，报告IPC与每秒提交的指令数（instructions）
+
+template <CoreConfig Config = BASE_CORE>
+static void run_ticks(benchmark::State &state, const StreamConfig &config) {
+    auto cpu = std::make_unique<CPU_State>();
+    write_program(*cpu, StreamGenerator::generate(config, false));
+    auto core = std::make_unique<BasicCore<Config>>();
+    auto model = std::make_unique<BasicCPU<Config>>();
+    for (auto _ : state) {
+        model->tick(*core, cpu->memory);
+    }
+    const double instructions = static_cast<double>(model->get_instruction_count());
+    state.counters["IPC"] = instructions / static_cast<double>(model->get_cycle_count());
+    state.counters["instructions"] = benchmark::Counter(instructions, benchmark::Counter::kIsRate);
+}
+
+static void BM_Tick(benchmark::State &state, StreamConfig config) { run_ticks(state, config); }
+BENCHMARK_CAPTURE(BM_Tick, alu, mix_config(1, 0, 0, 0));
+BENCHMARK_CAPTURE(BM_Tick, branch, mix_config(0.5, 0.5, 0, 0));
+BENCHMARK_CAPTURE(BM_Tick, load_store, mix_config(0.2, 0, 0.4, 0.4));
+
+// 同一指令流在各预先实例化的核配置上的每周期开销
+static void BM_TickCore(benchmark::State &state, CoreKind kind) {
+    const StreamConfig config = mix_config(0.5, 0.15, 0.2, 0.15);
+    if (kind == CoreKind::Medium) {
+        run_ticks<MEDIUM_CORE>(state, config);
+    } else if (kind == CoreKind::Large) {
+        run_ticks<LARGE_CORE>(state, config);
+    } else if (kind == CoreKind::Prf) {
+        run_ticks<PRF_CORE>(state, config);
+    } else {
+        run_ticks<BASE_CORE>(state, config);
+    }
+}
+BENCHMARK_CAPTURE(BM_TickCore, base, CoreKind::Base);
+BENCHMARK_CAPTURE(BM_TickCore, medium, CoreKind::Medium);
+BENCHMARK_CAPTURE(BM_TickCore, large, CoreKind::Large);
+BENCHMARK_CAPTURE(BM_TickCore, prf, CoreKind::Prf);
+
+// 参数网格：依赖距离 x 分支跳转概率(%) x Load别名比例(%)
+static void BM_Stream(benchmark::State &state) {
+    StreamConfig config = mix_config(0.5, 0.15, 0.2, 0.15);
+    config.dependency_distance = static_cast<uint32_t>(state.range(0));
+    config.branch_bias = state.range(1) / 100.0;
+    config.alias_rate = state.range(2) / 100.0;
+    run_ticks(state, config);
+}
+BENCHMARK(BM_Stream)
+    ->ArgNames({"distance", "bias", "alias"})
+    ->ArgsProduct({{1, 4, 16}, {50, 90, 100}, {0, 50, 100}});
+
+// ---------------------------------------------------------------------------
+// 程序加载：解析state.range(0)字节的十六进制映像
+
+static std::string build_image(size_t bytes) {
+    std::ostringstream image;
+    image << "@00000000\n";
+    char text[4];
+    for (size_t i = 0; i < bytes; ++i) {
+        std::snprintf(text, sizeof(text), "%02X", static_cast<unsigned>(i * 131 & 0xFF));
+        image << text << ((i & 15) == 15 ? '\n' : ' ');
+    }
+    return image.str();
+}
+
+static void BM_LoadProgram(benchmark::State &state) {
+    const std::string image = build_image(static_cast<size_t>(state.range(0)));
+    std::streambuf *saved = std::cin.rdbuf();
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto simulator = std::make_unique<RISCV_Simulator>();
+        std::istringstream input(image);
+        std::cin.rdbuf(input.rdbuf());
+        std::cin.clear();
+        state.ResumeTiming();
+        simulator->load_program();
+    }
+    std::cin.rdbuf(saved);
+    std::cin.clear();
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LoadProgram)->Arg(64 << 10)->Arg(512 << 10)->Unit(benchmark::kMillisecond);
+
+// ---------------------------------------------------------------------------
+// 端到端：加载并运行客户程序，输出被丢弃
+
+static void BM_Workload(benchmark::State &state, const std::string &path) {
+    std::ifstream file(path);
+    std::stringstream image;
+    image << file.rdbuf();
+    const std::string text = image.str();
+
+    std::streambuf *saved_in = std::cin.rdbuf();
+    std::streambuf *saved_out = std::cout.rdbuf();
+    std::ostringstream discard;
+    uint64_t instructions = 0;
+    uint64_t cycles = 0;
+    for (auto _ : state) {
+        auto simulator = std::make_unique<RISCV_Simulator>();
+        std::istringstream input(text);
+        std::cin.rdbuf(input.rdbuf());
+        std::cin.clear();
+        std::cout.rdbuf(discard.rdbuf());
+        simulator->load_program();
+        simulator->run();
+        std::cout.rdbuf(saved_out);
+        discard.str("");
+        instructions += simulator->get_instruction_count();
+        cycles += simulator->get_cycle_count();
+    }
+    std::cin.rdbuf(saved_in);
+    std::cin.clear();
+    state.counters["IPC"] = static_cast<double>(instructions) / static_cast<double>(cycles);
+    state.counters["instructions"] =
+        benchmark::Counter(static_cast<double>(instructions), benchmark::Counter::kIsRate);
+}
+
+// 为SIM_BENCH_WORKLOADS目录（默认为源码中的workloads/）下每个 .data 文件注册一个基准
+static void register_workloads() {
+    const char *dir = std::getenv("SIM_BENCH_WORKLOADS");
+    const std::filesystem::path root = dir ? dir : SIM_BENCH_WORKLOAD_DIR;
+    std::error_code error;
+    std::vector<std::filesystem::path> paths;
+    for (const auto &entry : std::filesystem::directory_iterator(root, error)) {
+        if (entry.path().extension() == ".data") {
+            paths.push_back(entry.path());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    for (const auto &path : paths) {
+        benchmark::RegisterBenchmark(("BM_Workload/" + path.stem().string()).c_str(),
+                                     BM_Workload, path.string())
+            ->Unit(benchmark::kMillisecond);
+    }
+}
+
+int main(int argc, char **argv) {
+    register_workloads();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,52 @@
+#ifndef BBV_PROFILER_H
+#define BBV_PROFILER_H
+
+#include "cpu_state.h"
+#include "instruction.h"
+
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+// 基本块向量统计，输出SimPoint的.bb格式:
+//   每个区间一行 "T:<块号>:<指令数> :<块号>:<指令数> ..."
+// 基本块以分支/跳转指令结束，块号按首次出现的顺序从1开始编号
+class BBVProfiler {
+  public:
+    BBVProfiler(std::ostream &out, uint64_t interval);
+
+    // 每执行一条指令调用一次
+    void on_instruction(uint32_t pc, InstrType type) {
+        if (block_length_ == 0) {
+            block_start_ = pc;
+        }
+        ++block_length_;
+        if (InstructionProcessor::is_control_flow_type(type)) {
+            end_block();
+        }
+    }
+
+    // 程序结束时调用，输出最后一个不完整的区间
+    void finish();
+
+    uint64_t get_interval_count() const { return interval_count_; }
+
+  private:
+    void end_block();
+    void write_interval();
+
+    std::ostream &out_;
+    uint64_t interval_;
+
+    uint32_t block_start_;
+    uint32_t block_length_;
+
+    std::unordered_map<uint32_t, uint32_t> block_ids_; // 块首地址 -> 块号
+    std::vector<uint64_t> counts_;                     // 按块号记录本区间执行的指令数
+    std::vector<uint32_t> touched_;                    // 本区间出现过的块号
+    uint64_t interval_instructions_;
+    uint64_t interval_count_;
+};
+
+#endif // BBV_PROFILER_H
@@ -0,0 +1,76 @@
+#ifndef BUS_H
+#define BUS_H
+
+#include "cpu_state.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// 内存映射设备接口，offset为相对设备基址的偏移，size为1/2/4字节
+class Device {
+  public:
+    virtual ~Device() = default;
+
+    virtual uint32_t read(uint32_t offset, uint32_t size) = 0;
+    virtual void write(uint32_t offset, uint32_t size, uint32_t value) = 0;
+};
+
+// 地址译码总线：[0, MEMORY_SIZE) 为RAM，其余地址按注册的区间分发给设备
+// RAM访问由调用方直接读写memory，不经过虚函数调用；只有is_ram为假时才调用read/write
+// 多核模拟时各hart在不同线程访问设备，read/write在总线锁内调用设备
+class Bus {
+  public:
+    Bus();
+
+    // 注册设备，不接管所有权；区间与RAM或已注册设备重叠时返回false
+    bool attach(uint32_t base, uint32_t size, Device *device);
+
+    // 从address开始的size字节是否全部位于RAM内
+    static bool is_ram(uint32_t address, uint32_t size) {
+        return address <= static_cast<uint32_t>(MEMORY_SIZE) - size;
+    }
+
+    // [address, address+size) 是否落在某个已注册设备的区间内
+    bool is_mapped(uint32_t address, uint32_t size) const {
+        uint32_t offset;
+        return lookup(address, size, offset) != nullptr;
+    }
+
+    // 访问设备，地址未映射时返回false（读出的值为0）
+    bool read(uint32_t address, uint32_t size, uint32_t &value);
+    bool write(uint32_t address, uint32_t size, uint32_t value);
+
+    // 设备请求结束模拟（如向tohost写入退出码）
+    void request_exit(uint32_t code);
+    bool has_exited() const { return exited_; }
+    uint32_t get_exit_code() const { return exit_code_; }
+
+    // 设备驱动的各hart中断线，按mip的位编号；处理器每周期采样到mip
+    void set_interrupt(uint32_t hart, uint32_t mask, bool pending) {
+        if (pending) {
+            pending_interrupts_[hart].fetch_or(mask);
+        } else {
+            pending_interrupts_[hart].fetch_and(~mask);
+        }
+    }
+    uint32_t get_pending_interrupts(uint32_t hart) const { return pending_interrupts_[hart]; }
+
+  private:
+    struct Mapping {
+        uint32_t base;
+        uint32_t size;
+        Device *device;
+    };
+
+    Device *lookup(uint32_t address, uint32_t size, uint32_t &offset) const;
+
+    std::vector<Mapping> mappings_;
+    std::mutex lock_;
+    std::atomic<bool> exited_;
+    uint32_t exit_code_;
+    std::atomic<uint32_t> pending_interrupts_[MAX_HARTS];
+};
+
+#endif // BUS_H
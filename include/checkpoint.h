@@ -0,0 +1,25 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "cpu_state.h"
+#include "devices.h"
+#include "process.h"
+
+#include <string>
+
+// 检查点文件格式:
+//   文件头 | CPU统计信息 | CPU_Core原始数据 | CLINT寄存器 | 非零内存页(可选zlib压缩)
+// CPU_Core按内存布局直接写入，因此检查点只能由同一配置编译出的模拟器读取
+
+const uint32_t CHECKPOINT_VERSION = 6;
+const uint32_t CHECKPOINT_PAGE_SIZE = 4096;
+
+// 保存检查点，失败时输出错误信息并返回false；program_break为系统调用维护的堆顶
+bool save_checkpoint(const std::string &path, const CPU_State &state, const CPU_Stats &stats,
+                     uint32_t program_break, const ClintState &clint);
+
+// 恢复检查点，失败时各输出参数保持不变
+bool load_checkpoint(const std::string &path, CPU_State &state, CPU_Stats &stats,
+                     uint32_t &program_break, ClintState &clint);
+
+#endif // CHECKPOINT_H
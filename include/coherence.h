@@ -0,0 +1,49 @@
+#ifndef COHERENCE_H
+#define COHERENCE_H
+
+#include "cpu_state.h"
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+// 多核共享内存的MSI目录：以缓存行为单位记录各hart的状态（M/S/I）
+// 不建模缓存容量，首次访问没有额外开销；只有在hart之间转移数据时
+// （读另一个hart的M行、写其他hart持有的行）计入一致性延迟
+class CoherenceDirectory {
+  public:
+    static const uint32_t LINE_SHIFT = 6;        // 64字节缓存行
+    static const uint32_t TRANSFER_LATENCY = 20; // 核间传输/失效的额外周期
+
+    CoherenceDirectory();
+
+    // hart访问address所在的行并完成状态转换，返回额外的延迟周期
+    uint32_t access(uint32_t hart, uint32_t address, bool write);
+
+    // hart是否仍持有该行（未被其他hart的写失效），用于SC.W检查保留
+    bool holds(uint32_t hart, uint32_t address);
+
+    // 共享内存的读写锁：取指与Load持共享锁；提交写内存、原子访存与系统调用持独占锁，
+    // 保证AMO的读-改-写不被其他hart打断，也不会读到其他hart写了一半的数据
+    std::shared_mutex &memory_lock() { return memory_lock_; }
+
+    uint64_t get_invalidations() const { return invalidations_; }
+    uint64_t get_interventions() const { return interventions_; }
+
+  private:
+    struct Line {
+        uint32_t sharers; // S状态的hart位图
+        int32_t owner;    // M状态的hart，-1表示没有
+
+        Line() : sharers(0), owner(-1) {}
+    };
+
+    std::mutex lock_;
+    std::shared_mutex memory_lock_;
+    std::unordered_map<uint32_t, Line> lines_;
+    uint64_t invalidations_; // 写操作使其他hart的副本失效的次数
+    uint64_t interventions_; // 读操作从其他hart的M行取数据的次数
+};
+
+#endif // COHERENCE_H
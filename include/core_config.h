@@ -0,0 +1,77 @@
+#ifndef CORE_CONFIG_H
+#define CORE_CONFIG_H
+
+#include <cstdint>
+
+// 乱序核的结构参数，作为模板参数在编译期确定：
+// 循环上界与单元数都是常量，容量为2的幂时环形队列下标用掩码回绕
+struct CoreConfig {
+    uint32_t rob_size;          // ROB条目数，最多同时容纳rob_size-1条指令
+    uint32_t rs_size;           // 预约站条目数
+    uint32_t lsb_size;          // Load/Store队列条目数
+    uint32_t fetch_buffer_size; // 取指缓存条目数，最多缓存fetch_buffer_size-1条
+    uint32_t alu_units;         // 每周期最多开始执行的ALU指令数
+    uint32_t load_units;        // 每周期最多执行的访存数
+    uint32_t mul_units;         // 流水化乘法器，每周期最多接收的乘法数
+    uint32_t div_units;         // 迭代除法器，同时执行的除法数
+    // 物理寄存器数；0表示结果暂存在ROB中、提交时写入架构寄存器，
+    // 否则为R10K式的统一物理寄存器堆，在译码时查映射表重命名
+    uint32_t phys_regs = 0;
+    // 重命名时消除寄存器复制与常数写法，只用于物理寄存器堆
+    bool rename_elimination = false;
+};
+
+// ROB索引的上限；NO_ROB_TAG表示操作数不依赖任何ROB条目，与配置无关
+const uint32_t MAX_ROB_SIZE = 64;
+const uint32_t NO_ROB_TAG = MAX_ROB_SIZE;
+// 预约站、LSB的占用位图为64位
+const uint32_t MAX_QUEUE_SIZE = 64;
+// 物理寄存器号与ROB索引一样用RobTag在CDB上广播，NO_ROB_TAG同样表示没有依赖
+const uint32_t MAX_PHYS_REGS = 64;
+
+// 压缩存放的ROB索引
+using RobTag = uint8_t;
+
+// 预先实例化的配置，BASE_CORE即原来的固定参数
+constexpr CoreConfig BASE_CORE = {5, 16, 16, 5, 1, 1, 1, 1};
+constexpr CoreConfig MEDIUM_CORE = {8, 16, 16, 8, 2, 1, 1, 1};
+constexpr CoreConfig LARGE_CORE = {32, 32, 32, 16, 4, 2, 2, 1};
+// 与LARGE_CORE相同的结构，改用物理寄存器堆：32个架构寄存器加上ROB中最多31条在途指令，
+// 并在重命名时消除复制与常数写法
+constexpr CoreConfig PRF_CORE = {32, 32, 32, 16, 4, 2, 2, 1, 64, true};
+
+// 运行时用 --core 选择的配置
+enum class CoreKind { Base, Medium, Large, Prf };
+
+template <CoreConfig Config> constexpr bool valid_core_config() {
+    const bool queues = Config.rob_size >= 2 && Config.rob_size <= MAX_ROB_SIZE &&
+                        Config.rs_size > 0 && Config.rs_size <= MAX_QUEUE_SIZE &&
+                        Config.lsb_size > 0 && Config.lsb_size <= MAX_QUEUE_SIZE &&
+                        Config.fetch_buffer_size >= 2;
+    const bool units = Config.alu_units > 0 && Config.load_units > 0 && Config.mul_units > 0 &&
+                       Config.div_units > 0;
+    const bool rename =
+        (Config.phys_regs == 0 || (Config.phys_regs > 32 && Config.phys_regs <= MAX_PHYS_REGS)) &&
+        (!Config.rename_elimination || Config.phys_regs != 0);
+    return queues && units && rename;
+}
+
+// 环形队列下标加一
+template <uint32_t N> constexpr uint32_t ring_next(uint32_t idx) {
+    if constexpr ((N & (N - 1)) == 0) {
+        return (idx + 1) & (N - 1);
+    } else {
+        return idx + 1 == N ? 0 : idx + 1;
+    }
+}
+
+// idx距队首head的位置
+template <uint32_t N> constexpr uint32_t ring_offset(uint32_t idx, uint32_t head) {
+    if constexpr ((N & (N - 1)) == 0) {
+        return (idx - head) & (N - 1);
+    } else {
+        return idx >= head ? idx - head : N - head + idx;
+    }
+}
+
+#endif // CORE_CONFIG_H
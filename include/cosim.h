@@ -0,0 +1,61 @@
+#ifndef COSIM_H
+#define COSIM_H
+
+#include "cpu_state.h"
+#include "functional_core.h"
+
+#include <cstdint>
+#include <memory>
+
+// 一条指令提交时的可观测结果
+struct CommitRecord {
+    uint32_t pc;
+    InstrType type;
+    uint32_t dest_reg;
+    uint32_t value; // 写回目标寄存器的值
+    bool is_store;
+    uint32_t store_address;
+    uint32_t store_value;
+};
+
+// 锁步差分检查：乱序流水线每提交一条指令，参考功能模型执行一条并比较结果
+class CosimChecker {
+  public:
+    // 以当前（刚加载完程序的）状态初始化参考模型；initial即被检查的状态，
+    // 其内存用于同步系统调用写入的数据
+    explicit CosimChecker(const CPU_State &initial);
+
+    // 参考模型须与流水线采用相同的非对齐访存策略
+    void set_misaligned_policy(MisalignedPolicy policy) {
+        reference_.set_misaligned_policy(policy);
+    }
+
+    // 参考模型按总线的地址映射判断访存是否引发访问错误，但不访问设备
+    void set_address_map(const Bus *bus) { reference_.set_address_map(bus); }
+
+    // 在commit_stage中每提交一条指令调用一次，发现不一致时输出状态并返回false
+    bool on_commit(const CommitRecord &record, const Registers &committed, uint64_t cycle);
+
+    // 流水线在pc处响应中断（cause为mcause的值），参考模型同步进入陷入
+    bool on_interrupt(uint32_t cause, uint32_t pc, const Registers &committed, uint64_t cycle);
+
+    // 停机时比较完整的寄存器堆
+    bool finish(const CPU_State &state, uint64_t cycle);
+
+    bool has_failed() const { return failed_; }
+    uint64_t get_checked_count() const { return checked_; }
+
+  private:
+    // 提交的是否为读出值依赖时序的CSR指令
+    bool reads_timing_csr(const CommitRecord &record) const;
+    void report(const char *what, const CommitRecord &record, const Registers &committed,
+                uint64_t expected, uint64_t actual, uint64_t cycle);
+
+    std::unique_ptr<CPU_State> golden_;
+    const uint8_t *dut_memory_;
+    FunctionalCore reference_;
+    bool failed_;
+    uint64_t checked_;
+};
+
+#endif // COSIM_H
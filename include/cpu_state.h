@@ -1,6 +1,9 @@
 #ifndef CPU_STATE_H
 #define CPU_STATE_H
 
+#include "core_config.h"
+
+#include <bit>
 #include <cstdint>
 #include <iostream>
 #include <string>
@@ -8,14 +11,8 @@
 using std::cerr;
 using std::cout;
 const int MEMORY_SIZE = 1024 * 1024;
+const uint32_t MAX_HARTS = 8; // 多核模拟的最大hart数
 const uint32_t HALT_INSTRUCTION = 0x0ff00513;
-const int ROB_SIZE = 5;
-const int RS_SIZE = 16;
-const int LSB_SIZE = 16;
-const int BROAD_SIZE = 16;
-const int FETCH_BUFFER_SIZE = 5;
-const int MAX_ALU_UNITS = 1;
-const int MAX_LOAD_UNITS = 1;
 
 //指令类别
 enum class InstrType {
@@ -38,6 +35,14 @@ enum class InstrType {
     ALU_SRAI,
     ALU_SLTI,
     ALU_SLTIU,
+    MUL, // RV32M
+    MULH,
+    MULHSU,
+    MULHU,
+    DIV,
+    DIVU,
+    REM,
+    REMU,
     LOAD_LB,
     LOAD_LH,
     LOAD_LW,
@@ -56,28 +61,91 @@ enum class InstrType {
     JUMP_JALR,
     LUI,
     AUIPC,
+    CSRRW, // Zicsr，提交时串行执行
+    CSRRS,
+    CSRRC,
+    CSRRWI,
+    CSRRSI,
+    CSRRCI,
+    LR_W, // RV32A，提交时串行执行
+    SC_W,
+    AMOSWAP_W,
+    AMOADD_W,
+    AMOXOR_W,
+    AMOAND_W,
+    AMOOR_W,
+    AMOMIN_W,
+    AMOMAX_W,
+    AMOMINU_W,
+    AMOMAXU_W,
+    FENCE, // FENCE/FENCE.I，提交时串行执行
+    ECALL, // 系统调用，提交时串行执行
+    EBREAK,
+    MRET, // 从陷入返回，提交时串行执行
+    WFI,  // 等待中断，提交时串行执行
+    ILLEGAL, // 无法识别的编码或取指越界，提交时引发异常
     HALT
 };
 
+// 异常原因，取值与mcause一致
+enum class ExceptionCause : uint32_t {
+    InstructionAccessFault = 1,
+    IllegalInstruction = 2,
+    Breakpoint = 3,
+    LoadAddressMisaligned = 4,
+    LoadAccessFault = 5,
+    StoreAddressMisaligned = 6,
+    StoreAccessFault = 7,
+    EnvironmentCallFromM = 11,
+    None = 0xFFFFFFFF,
+};
+
+// 提交时引发的异常
+struct ExceptionRecord {
+    ExceptionCause cause;
+    uint32_t pc;
+    uint32_t tval; // 非法指令为原始编码，取指越界与非对齐访存为访问地址
+    uint32_t hart;
+
+    ExceptionRecord() : cause(ExceptionCause::None), pc(0), tval(0), hart(0) {}
+};
+
 std::string Type_string(InstrType type);
 
 // 取指缓存条目
 struct FetchBufferEntry {
     bool valid;           // 条目是否有效
-    uint32_t instruction; // 指令内容
+    uint32_t instruction; // 指令内容，压缩指令只占低16位
     uint32_t pc;          // 指令地址
+    bool access_fault;    // 取指越界，译码后作为异常指令提交
 
-    FetchBufferEntry() : valid(false), instruction(0), pc(0) {}
+    FetchBufferEntry() : valid(false), instruction(0), pc(0), access_fault(false) {}
 };
 
 // 指令状态枚举
-enum class InstrState {
+enum class InstrState : uint8_t {
     Dispatch,  // 已分派到预约站
     Execute,   // 正在执行
     Writeback, // 写回完成
     Commit     // 可以提交
 };
 
+// 重命名时识别出的、不需要执行单元的指令
+enum class RenameIdiom : uint8_t {
+    None,
+    Move,    // 寄存器复制，目标寄存器直接映射到源寄存器的物理寄存器
+    Constant // 结果为常数，重命名时直接写入新分配的物理寄存器
+};
+
+// 译码时融合为一个ROB条目的相邻指令对，两条指令的目标寄存器相同
+enum class FusionKind : uint8_t {
+    None,
+    LuiAddi,   // lui rd, hi; addi rd, rd, lo，融合为lui rd, hi+lo
+    AuipcJalr, // auipc rd, hi; jalr rd, lo(rd)，融合为jal rd, hi+lo
+    SlliSrli,  // slli rd, rs, k; srli rd, rd, k，融合为andi rd, rs, 0xFFFFFFFF>>k
+};
+const uint32_t FUSION_KINDS = 4;
+
 // 寄存器
 struct Registers {
     struct Reg {
@@ -85,7 +153,7 @@ struct Registers {
         bool busy;        // 是否被预定
         uint32_t rob_idx; //  预定它的ROB索引
 
-        Reg() : value(0), busy(false), rob_idx(ROB_SIZE) {}
+        Reg() : value(0), busy(false), rob_idx(NO_ROB_TAG) {}
     };
 
     Reg reg[32];
@@ -122,12 +190,12 @@ struct Registers {
     void clear_busy(uint32_t reg_idx) {
         if (reg_idx != 0) {
             reg[reg_idx].busy = false;
-            reg[reg_idx].rob_idx = ROB_SIZE;
+            reg[reg_idx].rob_idx = NO_ROB_TAG;
         }
     }
     void flush() {
         for (int i = 0; i < 32; i++)
-            reg[i].busy = 0, reg[i].rob_idx = ROB_SIZE;
+            reg[i].busy = 0, reg[i].rob_idx = NO_ROB_TAG;
     }
     void print_status() const {
         for (int i = 0; i < 32; i++) {
@@ -137,15 +205,38 @@ struct Registers {
     }
 };
 
-// 重排序缓冲区
+// 有存储的CSR；计数器的值为执行模型自身的计数加上这里保存的偏移，
+// 写入mcycle/minstret或在功能模型与流水线模型之间切换时只需调整偏移
+struct CSRFile {
+    uint32_t mhartid;
+    uint32_t mscratch;
+    uint64_t cycle_offset;
+    uint64_t instret_offset;
+
+    // 机器模式陷入
+    uint32_t mstatus;
+    uint32_t mtvec; // 为0表示没有陷入处理程序，异常直接结束模拟
+    uint32_t mepc;
+    uint32_t mcause;
+    uint32_t mtval;
+    uint32_t mie;
+    uint32_t mip; // 每周期由总线的中断线采样，软件写入无效
+
+    CSRFile()
+        : mhartid(0), mscratch(0), cycle_offset(0), instret_offset(0), mstatus(0), mtvec(0),
+          mepc(0), mcause(0), mtval(0), mie(0), mip(0) {}
+};
+
+// 重排序缓冲区；占用位与指令状态在BasicCore中单独存放
 struct ROBEntry {
-    bool busy;            // 是否被占用
     InstrType instr_type; // 指令类型
-    InstrState state;     // 指令状态
     uint32_t dest_reg;    // 目标寄存器编号
     uint32_t value;       // 计算结果
     uint32_t mem_address; // 内存地址（Load/Store用）
     uint32_t pc;          // 指令地址
+    uint32_t length;      // 指令长度（2或4字节）
+    uint32_t raw;         // 原始编码，报告非法指令时使用
+    ExceptionCause exception; // 译码/执行时检测到的异常，提交时按序引发
 
     // 分支指令专用
     bool is_branch;       // 是否是分支指令
@@ -157,32 +248,39 @@ struct ROBEntry {
     uint32_t rs1, rs2; // 源寄存器编号
     uint32_t imm;      // 立即数
 
+    // 物理寄存器堆模式下译码时重命名的结果，不写寄存器的指令phys_dest为NO_ROB_TAG
+    RobTag phys_rs1, phys_rs2; // 源寄存器映射到的物理寄存器
+    RobTag phys_dest;          // 新分配的目标物理寄存器
+    RobTag old_phys_dest;      // 目标寄存器原来的映射，提交时释放
+    RenameIdiom idiom;         // 重命名时被消除的指令，不经过预约站
+
+    // 融合的指令对：pc、length覆盖两条指令，提交时按两条计数并分别做差分检查
+    FusionKind fusion;
+    uint32_t first_length; // 第一条指令的长度
+    uint32_t first_value;  // 第一条指令的结果，lui、auipc在译码时即可确定
+
     ROBEntry()
-        : busy(false), value(0), is_branch(false), predicted_taken(false), actual_taken(false),
-          rs1(0), rs2(0), imm(0) {}
+        : value(0), length(4), raw(0), exception(ExceptionCause::None),
+          is_branch(false), predicted_taken(false), actual_taken(false), rs1(0), rs2(0),
+          imm(0), phys_rs1(0), phys_rs2(0), phys_dest(NO_ROB_TAG), old_phys_dest(NO_ROB_TAG),
+          idiom(RenameIdiom::None), fusion(FusionKind::None), first_length(0), first_value(0) {}
 };
 
-// 预约站
+// 预约站；占用位与操作数依赖的ROB索引（Qj、Qk）在BasicCore中单独存放
 struct RSEntry {
-    bool busy;             // 是否被占用
     InstrType op;          // 操作类型
     uint32_t Vj, Vk;       // 操作数值
-    uint32_t Qj, Qk;       // 操作数依赖的ROB索引
     uint32_t dest_rob_idx; // 对应的ROB条目索引
     uint32_t imm;          // 立即数
 
     // 执行计时器
     int execution_cycles_left;
 
-    RSEntry() : busy(false), Qj(ROB_SIZE), Qk(ROB_SIZE), execution_cycles_left(0) {}
-
-    // 检查操作数是否都就绪
-    bool operands_ready() const { return Qj == ROB_SIZE && Qk == ROB_SIZE; }
+    RSEntry() : execution_cycles_left(0) {}
 };
 
-// Load/Store队列
+// Load/Store队列；占用位与基址、存储值依赖的ROB索引在BasicCore中单独存放
 struct LSBEntry {
-    bool busy;             // 是否被占用
     InstrType op;          // LOAD或STORE类型
     uint32_t address;      // 内存地址
     uint32_t value;        // 要存储的值
@@ -191,47 +289,94 @@ struct LSBEntry {
     uint32_t rob_idx;      // 在ROB中的位置
 
     // 地址计算操作数
-    uint32_t base_value;   // 基址寄存器的值
-    uint32_t base_rob_idx; // 基址寄存器依赖的ROB索引
-    uint32_t offset;       // 偏移量
-
-    uint32_t value_rob_idx; // 存储值依赖的ROB索引
+    uint32_t base_value; // 基址寄存器的值
+    uint32_t offset;     // 偏移量
 
     uint32_t execution_cycles_left; // 执行周期计数器
 
     bool execute_completed; // 标记execute阶段是否已完成
 
-    LSBEntry()
-        : busy(false), address_ready(false), base_rob_idx(0), value_rob_idx(0),
-          execution_cycles_left(0), execute_completed(false) {}
+    LSBEntry() : address_ready(false), execution_cycles_left(0), execute_completed(false) {}
 };
 
-// 公共数据总线广播结果
-struct BroadcastResult {
-    bool valid;       // 是否有有效广播
-    uint32_t rob_idx; // 产生结果的ROB索引
-    uint32_t value;   // 广播的值
+// 条目占用位图，第i位为1表示第i个条目被占用，最多64个条目
+struct BusyBits {
+    uint64_t bits;
+
+    BusyBits() : bits(0) {}
+
+    bool test(uint32_t idx) const { return (bits >> idx) & 1; }
+    void set(uint32_t idx) { bits |= uint64_t(1) << idx; }
+    void reset(uint32_t idx) { bits &= ~(uint64_t(1) << idx); }
+
+    // 前n个条目中第一个空闲条目，全部占用时返回n
+    uint32_t first_free(uint32_t n) const {
+        const uint64_t used = n < 64 ? bits | ~((uint64_t(1) << n) - 1) : bits;
+        return ~used ? std::countr_zero(~used) : n;
+    }
+};
 
-    BroadcastResult() : valid(false), rob_idx(0), value(0) {}
+// 统一物理寄存器堆与重命名映射表，N为物理寄存器数
+template <uint32_t N> struct PhysRegFile {
+    uint32_t value[N];
+    BusyBits ready;          // 值已写回的物理寄存器
+    BusyBits mapped;         // 空闲列表的补集，第i位为0表示物理寄存器i空闲
+    uint8_t refs[N];         // 映射到各物理寄存器的映射表项数，消除的复制指令使其共享
+    RobTag rename_map[32];   // 推测映射表，译码时查询与更新
+    RobTag commit_map[32];   // 提交映射表，冲刷时作为恢复映射表的检查点
 };
 
+// 结果暂存在ROB中的核没有物理寄存器堆
+template <> struct PhysRegFile<0> {};
+
+// 公共数据总线，收集一个周期内写回的全部结果；
+// 标签为产生结果的ROB索引，物理寄存器堆模式下为目标物理寄存器
 struct CDB {
-    BroadcastResult result[BROAD_SIZE];
+    uint32_t count;               // 本周期的结果数
+    RobTag tag[MAX_ROB_SIZE];     // 结果的标签
+    uint32_t value[MAX_ROB_SIZE]; // 结果值，按标签存放
+
+    CDB() : count(0) {}
 };
 
-// CPU核心
-struct CPU_Core {
+// CPU核心，各队列的容量由Config决定
+template <CoreConfig Config> struct BasicCore {
+    static_assert(valid_core_config<Config>(), "invalid core configuration");
 
-    CPU_Core();
+    BasicCore();
 
     uint32_t pc;    // 内存访问地址
     Registers Regs; // 寄存器
-
-    FetchBufferEntry fetch_buffer[FETCH_BUFFER_SIZE]; // 指令缓存队列 // 寄存器别名表
-    ROBEntry rob[ROB_SIZE];                           // 重排序缓冲区
-    RSEntry rs_alu[RS_SIZE];                          // ALU预约站
-    RSEntry rs_branch[RS_SIZE / 2];                   // 分支预约站
-    LSBEntry LSB[LSB_SIZE];                           // Load/Store队列
+    CSRFile csr;    // 控制状态寄存器，只在提交时读写
+
+    FetchBufferEntry fetch_buffer[Config.fetch_buffer_size]; // 指令缓存队列
+    ROBEntry rob[Config.rob_size];                           // 重排序缓冲区
+    RSEntry rs_alu[Config.rs_size];                          // ALU预约站
+    RSEntry rs_branch[Config.rs_size / 2];                   // 分支预约站
+    LSBEntry LSB[Config.lsb_size];                           // Load/Store队列
+
+    // 各阶段每周期都要扫描的字段，按下标与上面的条目一一对应：
+    // 占用位压缩为位图，ROB索引压缩为RobTag，便于整段比较
+    BusyBits rob_busy;
+    InstrState rob_state[Config.rob_size];
+    BusyBits rs_busy;
+    RobTag rs_qj[Config.rs_size]; // 操作数依赖的ROB索引，NO_ROB_TAG表示已就绪
+    RobTag rs_qk[Config.rs_size];
+    BusyBits lsb_busy;
+    RobTag lsb_base_tag[Config.lsb_size];  // 基址寄存器依赖的ROB索引
+    RobTag lsb_value_tag[Config.lsb_size]; // 存储值依赖的ROB索引
+
+    // 物理寄存器堆，只在Config.phys_regs不为0时有内容
+    [[no_unique_address]] PhysRegFile<Config.phys_regs> prf;
+
+    // 把推测映射表恢复为提交映射表并回收其余物理寄存器，
+    // 再把架构寄存器的值写入各自映射到的物理寄存器；没有物理寄存器堆时什么也不做
+    void restore_rename_map();
+
+    // 预约站第idx项的操作数是否都就绪
+    bool rs_ready(uint32_t idx) const {
+        return rs_qj[idx] == NO_ROB_TAG && rs_qk[idx] == NO_ROB_TAG;
+    }
 
     // 指令缓存队列
     uint32_t fetch_buffer_head;
@@ -248,14 +393,21 @@ struct CPU_Core {
 
     // 流水线状态
     bool fetch_stalled;    // 取指是否停滞
+    bool fetch_blocked;    // 取指越界后暂停取指，直到流水线冲刷
     bool pipeline_flushed; // 流水线是否被冲刷
 
     bool clear_flag;  //标记上回合是否被清空
     bool commit_flag; // 周期中有commit
     uint32_t next_pc;
 
+    // LR.W建立的保留，SC.W检查后清除
+    bool reservation_valid;
+    uint32_t reservation_address;
+
 };
 
+using CPU_Core = BasicCore<BASE_CORE>;
+
 struct CPU_State {
     CPU_Core core;
     uint8_t memory[MEMORY_SIZE];
@@ -0,0 +1,81 @@
+#ifndef CSR_H
+#define CSR_H
+
+#include "cpu_state.h"
+
+#include <cstdint>
+
+// CSR地址
+const uint32_t CSR_MSTATUS = 0x300;
+const uint32_t CSR_MISA = 0x301;
+const uint32_t CSR_MIE = 0x304;
+const uint32_t CSR_MTVEC = 0x305;
+const uint32_t CSR_MSCRATCH = 0x340;
+const uint32_t CSR_MEPC = 0x341;
+const uint32_t CSR_MCAUSE = 0x342;
+const uint32_t CSR_MTVAL = 0x343;
+const uint32_t CSR_MIP = 0x344;
+const uint32_t CSR_MCYCLE = 0xB00;
+const uint32_t CSR_MINSTRET = 0xB02;
+const uint32_t CSR_MCYCLEH = 0xB80;
+const uint32_t CSR_MINSTRETH = 0xB82;
+const uint32_t CSR_CYCLE = 0xC00;
+const uint32_t CSR_TIME = 0xC01;
+const uint32_t CSR_INSTRET = 0xC02;
+const uint32_t CSR_CYCLEH = 0xC80;
+const uint32_t CSR_TIMEH = 0xC81;
+const uint32_t CSR_INSTRETH = 0xC82;
+const uint32_t CSR_MVENDORID = 0xF11;
+const uint32_t CSR_MARCHID = 0xF12;
+const uint32_t CSR_MIMPID = 0xF13;
+const uint32_t CSR_MHARTID = 0xF14;
+
+// mstatus字段，只实现机器模式，MPP恒为3
+const uint32_t MSTATUS_MIE = 1u << 3;
+const uint32_t MSTATUS_MPIE = 1u << 7;
+const uint32_t MSTATUS_MPP = 3u << 11;
+
+// mie/mip中的机器模式中断位，mcause中的中断标志
+const uint32_t MIP_MSIP = 1u << 3;
+const uint32_t MIP_MTIP = 1u << 7;
+const uint32_t MIP_MEIP = 1u << 11;
+const uint32_t MCAUSE_INTERRUPT = 1u << 31;
+
+// 执行模型自身计数器的当前值；time与CLINT的mtime一致，即周期数
+struct CSRCounters {
+    uint64_t cycle;
+    uint64_t instret; // 不含当前这条CSR指令
+};
+
+// Zicsr指令的执行
+class CSRProcessor {
+  public:
+    // 执行一条CSR指令：address为CSR地址，rs1为rs1字段（立即数形式即uimm），
+    // operand为rs1的值或uimm；返回false表示CSR不存在或写入只读CSR（非法指令），
+    // 此时不修改任何状态；old_value为写入rd的旧值
+    static bool execute(CSRFile &csr, const CSRCounters &counters, InstrType op,
+                        uint32_t address, uint32_t rs1, uint32_t operand, uint32_t &old_value);
+
+    static bool read(const CSRFile &csr, const CSRCounters &counters, uint32_t address,
+                     uint32_t &value);
+
+    // 读出的值依赖时序（计数器与mip），功能模型与流水线模型的结果不可比较
+    static bool depends_on_timing(uint32_t address);
+
+    // 是否设置了陷入处理程序；没有时异常直接结束模拟
+    static bool traps_enabled(const CSRFile &csr) { return csr.mtvec != 0; }
+
+    // 已使能且等待处理的最高优先级中断，返回mcause的值，没有时返回0
+    static uint32_t pending_interrupt(const CSRFile &csr);
+
+    // 进入陷入：保存mepc/mcause/mtval并关中断，返回处理程序地址
+    static uint32_t enter_trap(CSRFile &csr, uint32_t cause, uint32_t pc, uint32_t tval);
+
+    // MRET：恢复中断使能，返回mepc
+    static uint32_t return_from_trap(CSRFile &csr);
+
+    // 执行模型由from切换到to时调整偏移，使客户程序看到的计数器保持连续
+    static void rebase(CSRFile &csr, const CSRCounters &from, const CSRCounters &to);
+};
+
+#endif // CSR_H
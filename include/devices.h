@@ -0,0 +1,94 @@
+#ifndef DEVICES_H
+#define DEVICES_H
+
+#include "bus.h"
+#include "event_queue.h"
+#include "syscall_handler.h"
+
+#include <cstdint>
+#include <functional>
+
+// 设备地址布局（与QEMU virt平台一致）
+const uint32_t CLINT_BASE = 0x02000000;
+const uint32_t CLINT_SIZE = 0x10000;
+const uint32_t UART_BASE = 0x10000000;
+const uint32_t UART_SIZE = 0x100;
+const uint32_t TOHOST_BASE = 0x10001000;
+const uint32_t TOHOST_SIZE = 8;
+
+// 16550兼容串口的最小子集：THR/RBR收发字节，LSR给出收发状态
+// 收发经过SyscallHandler，与write/read系统调用共用缓冲区，输出顺序一致
+class Uart : public Device {
+  public:
+    explicit Uart(SyscallHandler &console) : console_(console) {}
+
+    uint32_t read(uint32_t offset, uint32_t size) override;
+    void write(uint32_t offset, uint32_t size, uint32_t value) override;
+
+  private:
+    static const uint32_t REG_DATA = 0; // THR/RBR
+    static const uint32_t REG_LSR = 5;
+    static const uint32_t LSR_DATA_READY = 0x01;
+    static const uint32_t LSR_THR_EMPTY = 0x20;
+    static const uint32_t LSR_TX_IDLE = 0x40;
+
+    SyscallHandler &console_;
+};
+
+// CLINT的可写寄存器，保存在检查点中；到期事件由mtimecmp重新登记，不需要另外保存
+struct ClintState {
+    uint32_t msip[MAX_HARTS];
+    uint64_t mtimecmp[MAX_HARTS];
+
+    ClintState() {
+        for (uint32_t i = 0; i < MAX_HARTS; ++i) {
+            msip[i] = 0;
+            mtimecmp[i] = UINT64_MAX;
+        }
+    }
+};
+
+// CLINT：mtime由clock给出（流水线周期数），只读；每个hart有各自的msip与mtimecmp，
+// mtime >= mtimecmp 时置位MTIP，msip最低位驱动MSIP。
+// 写mtimecmp时向事件队列登记到期事件并取消之前的事件，不需要每周期比较；
+// mtimecmp全为1表示关闭定时器，不登记事件
+class Clint : public Device {
+  public:
+    Clint(Bus &bus, EventQueue &events, std::function<uint64_t()> clock);
+
+    uint32_t read(uint32_t offset, uint32_t size) override;
+    void write(uint32_t offset, uint32_t size, uint32_t value) override;
+
+    const ClintState &get_state() const { return regs_; }
+    // 恢复检查点中的寄存器：按msip与mtimecmp重新驱动中断线并登记到期事件
+    void set_state(const ClintState &state);
+
+  private:
+    static const uint32_t REG_MSIP = 0x0;        // 每个hart 4字节
+    static const uint32_t REG_MTIMECMP = 0x4000; // 每个hart 8字节
+    static const uint32_t REG_MTIME = 0xBFF8;
+
+    // 按hart新的mtimecmp更新MTIP并重新登记到期事件
+    void update_timer(uint32_t hart);
+
+    Bus &bus_;
+    EventQueue &events_;
+    std::function<uint64_t()> clock_;
+    ClintState regs_;
+    bool timer_scheduled_[MAX_HARTS];          // 是否有尚未到期的事件
+    EventQueue::EventId timer_event_[MAX_HARTS]; // 尚未到期的事件，改写mtimecmp时取消
+};
+
+// riscv-tests风格的退出寄存器：写入最低位为1的值时以 value>>1 为退出码结束模拟
+class ToHost : public Device {
+  public:
+    explicit ToHost(Bus &bus) : bus_(bus) {}
+
+    uint32_t read(uint32_t offset, uint32_t size) override { return 0; }
+    void write(uint32_t offset, uint32_t size, uint32_t value) override;
+
+  private:
+    Bus &bus_;
+};
+
+#endif // DEVICES_H
@@ -0,0 +1,38 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <utility>
+
+// 离散事件队列：设备按模拟周期登记事件，主循环每周期只需比较堆顶，
+// 不必逐个轮询设备；核心空闲（WFI）时可以直接跳到下一个事件
+class EventQueue {
+  public:
+    using Action = std::function<void()>;
+    // 事件的标识：（时刻，登记序号）
+    using EventId = std::pair<uint64_t, uint64_t>;
+
+    EventQueue() : next_seq_(0) {}
+
+    // 登记在cycle时刻执行的事件，同一时刻按登记顺序执行
+    EventId schedule(uint64_t cycle, Action action);
+    // 取消尚未执行的事件，事件已执行时不做任何事
+    void cancel(const EventId &id) { events_.erase(id); }
+
+    // 执行所有时刻不晚于now的事件，事件中登记的新事件若已到期也一并执行
+    void run_until(uint64_t now);
+
+    bool empty() const { return events_.empty(); }
+    // 最早事件的时刻，队列为空时返回UINT64_MAX
+    uint64_t next_cycle() const {
+        return events_.empty() ? UINT64_MAX : events_.begin()->first.first;
+    }
+
+  private:
+    std::map<EventId, Action> events_; // 按时刻、登记顺序排列，可按标识取消
+    uint64_t next_seq_;
+};
+
+#endif // EVENT_QUEUE_H
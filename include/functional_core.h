@@ -0,0 +1,79 @@
+#ifndef FUNCTIONAL_CORE_H
+#define FUNCTIONAL_CORE_H
+
+#include "bbv_profiler.h"
+#include "bus.h"
+#include "cpu_state.h"
+#include "instruction.h"
+#include "memory_access.h"
+#include "syscall_handler.h"
+
+#include <cstdint>
+
+// 功能模型：逐条执行指令，不建模流水线时序
+// 架构状态直接使用 CPU_State 中的 pc、Regs 的值以及 memory，
+// 因此可以与乱序流水线模型互相切换
+class FunctionalCore {
+  public:
+    // 最近一条指令的Store信息，供差分检查使用
+    struct StoreAccess {
+        bool valid;
+        uint32_t address;
+        uint32_t value; // 源寄存器的完整值
+    };
+
+    FunctionalCore();
+
+    // 执行pc处的一条指令，遇到停机指令、异常或已经exit时返回false且不改变状态；
+    // 设置了mtvec时异常进入陷入处理程序，返回true但不计入退休的指令数
+    bool step(CPU_State &cpu);
+
+    // 最多执行max_instructions条指令，返回实际执行的条数
+    uint64_t run(CPU_State &cpu, uint64_t max_instructions);
+
+    // 挂接系统调用处理，未挂接时ECALL不产生任何效果
+    void set_syscall_handler(SyscallHandler *syscalls) { syscalls_ = syscalls; }
+
+    // 挂接设备总线；RAM与已注册设备以外的访存引发访问错误
+    void set_bus(Bus *bus) {
+        bus_ = bus;
+        address_map_ = bus;
+    }
+    // 只用总线判断地址是否映射、不访问设备（差分检查的参考模型），设备读出0、写入被丢弃
+    void set_address_map(const Bus *bus) { address_map_ = bus; }
+
+    void set_misaligned_policy(MisalignedPolicy policy) { misaligned_policy_ = policy; }
+
+    // 挂接基本块向量统计，传入nullptr关闭
+    void set_bbv_profiler(BBVProfiler *bbv) { bbv_ = bbv; }
+
+    const StoreAccess &get_last_store() const { return last_store_; }
+    // 最近一条指令是否访问了RAM以外的地址
+    bool last_was_device_access() const { return last_device_access_; }
+
+    bool is_halted() const { return halted_; }
+    // 引发的异常，cause为None表示没有
+    const ExceptionRecord &get_exception() const { return exception_; }
+    uint64_t get_instruction_count() const { return instruction_count_; }
+
+  private:
+    // 地址是否属于已注册的设备
+    bool is_mapped(uint32_t address, uint32_t size) const {
+        return address_map_ && address_map_->is_mapped(address, size);
+    }
+    // 有陷入处理程序时跳转过去并返回true，否则记录异常并停机
+    bool raise_exception(CPU_State &cpu, ExceptionCause cause, uint32_t pc, uint32_t tval);
+
+    BBVProfiler *bbv_;
+    SyscallHandler *syscalls_;
+    Bus *bus_;
+    const Bus *address_map_;
+    bool halted_;
+    uint64_t instruction_count_;
+    StoreAccess last_store_;
+    bool last_device_access_;
+    ExceptionRecord exception_;
+    MisalignedPolicy misaligned_policy_;
+};
+
+#endif // FUNCTIONAL_CORE_H
@@ -4,6 +4,7 @@
 #include "cpu_state.h"
 
 #include <cstdint>
+#include <string>
 
 // 解码后的指令信息
 struct Instruction {
@@ -11,31 +12,67 @@ struct Instruction {
     uint32_t rd, rs1, rs2; // 寄存器索引
     int32_t imm;           // 立即数
     uint32_t pc;           // 指令地址
-    uint32_t raw;          // 原始指令编码
+    uint32_t raw;          // 原始指令编码，压缩指令只占低16位
+    uint32_t length;       // 指令长度，2（RV32C）或4字节
 
-    Instruction() : type(InstrType::HALT), rd(0), rs1(0), rs2(0), imm(0), pc(0), raw(0) {}
+    Instruction()
+        : type(InstrType::HALT), rd(0), rs1(0), rs2(0), imm(0), pc(0), raw(0), length(4) {}
 };
 
 class InstructionProcessor {
   public:
-    // 指令解码
+    // 取出pc处的指令编码，压缩指令只取16位；越界时返回false
+    static bool fetch(const uint8_t memory[], uint32_t pc, uint32_t &raw);
+
+    // 指令解码，压缩指令先展开为等价的32位形式
     static Instruction decode(uint32_t raw_instruction, uint32_t pc);
 
+    // RV32C
+    static bool is_compressed(uint32_t raw) { return (raw & 0x3) != 0x3; }
+    static uint32_t expand_compressed(uint16_t raw); // 非法编码返回0
+
     // 指令类型判断
     static bool is_alu_type(InstrType type);
     static bool is_branch_type(InstrType type);
+    static bool is_mul_type(InstrType type);    // 乘法，流水化乘法器执行
+    static bool is_div_type(InstrType type);    // 除法/取余，迭代除法器执行
+    static bool is_muldiv_type(InstrType type); // RV32M
     static bool is_load_type(InstrType type);
     static bool is_store_type(InstrType type);
+    static bool is_csr_type(InstrType type);
+    static bool is_atomic_type(InstrType type); // RV32A
+    static bool is_control_flow_type(InstrType type); // 条件分支与跳转
+
+    // 重命名时可以消除的写法：复制（addi rd, rs, 0 等）时source为被复制的寄存器，
+    // 常数（addi rd, x0, imm、xor rd, rs, rs 等）时constant为结果
+    static RenameIdiom rename_idiom(const Instruction &instr, uint32_t &source,
+                                    uint32_t &constant);
+
+    // 相邻的两条指令能否融合，能融合时fused为融合后的指令，
+    // first_value为第一条指令的结果（slli+srli时不需要）
+    static FusionKind fuse(const Instruction &first, const Instruction &second,
+                           Instruction &fused, uint32_t &first_value);
+
+    // 访存宽度（字节）
+    static uint32_t get_access_size(InstrType type);
+    // 按Load类型对读出的低位数据做符号/零扩展
+    static uint32_t extend_load(InstrType type, uint32_t data);
 
     // ALU操作执行
     static uint32_t execute_alu(InstrType op, uint32_t val1, uint32_t val2, int32_t imm);
 
+    // AMO指令写回内存的新值，old为内存原值，operand为rs2的值
+    static uint32_t execute_amo(InstrType op, uint32_t old, uint32_t operand);
+
     // 分支条件检查
     static bool check_branch_condition(InstrType branch_type, uint32_t val1, uint32_t val2);
 
     // 执行周期获取
     static int get_execution_cycles(InstrType type);
 
+    // 反汇编为可读文本
+    static std::string disassemble(const Instruction &instr);
+
   private:
     static InstrType decode_opcode(uint32_t instruction);
     static int32_t extract_immediate(uint32_t instruction, InstrType type);
@@ -0,0 +1,78 @@
+#ifndef MEMORY_ACCESS_H
+#define MEMORY_ACCESS_H
+
+#include "cpu_state.h"
+
+#include <cstdint>
+#include <cstring>
+
+// 非对齐访存的处理方式
+enum class MisalignedPolicy {
+    Emulate, // 按字节拼接完成访问
+    Trap,    // 在提交时引发地址非对齐异常
+};
+
+// RAM的小端读写；调用方先用 Bus::is_ram 确认 [address, address+size) 在范围内
+// memcpy对任意对齐都是合法的，在常见主机上编译为单条访存指令
+class MemoryAccess {
+  public:
+    static bool is_aligned(uint32_t address, uint32_t size) {
+        return (address & (size - 1)) == 0;
+    }
+
+    // 读出size（1/2/4）字节，零扩展到32位
+    static uint32_t read(const uint8_t memory[], uint32_t address, uint32_t size) {
+        switch (size) {
+        case 1:
+            return memory[address];
+        case 2: {
+            uint16_t value;
+            std::memcpy(&value, &memory[address], sizeof(value));
+            return from_little_endian(value);
+        }
+        default: {
+            uint32_t value;
+            std::memcpy(&value, &memory[address], sizeof(value));
+            return from_little_endian(value);
+        }
+        }
+    }
+
+    // 写入value的低size字节
+    static void write(uint8_t memory[], uint32_t address, uint32_t size, uint32_t value) {
+        switch (size) {
+        case 1:
+            memory[address] = static_cast<uint8_t>(value);
+            break;
+        case 2: {
+            uint16_t data = from_little_endian(static_cast<uint16_t>(value));
+            std::memcpy(&memory[address], &data, sizeof(data));
+            break;
+        }
+        default: {
+            uint32_t data = from_little_endian(value);
+            std::memcpy(&memory[address], &data, sizeof(data));
+            break;
+        }
+        }
+    }
+
+  private:
+    // 小端与主机字节序互转，小端主机上为空操作
+    static uint16_t from_little_endian(uint16_t value) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return __builtin_bswap16(value);
+#else
+        return value;
+#endif
+    }
+    static uint32_t from_little_endian(uint32_t value) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return __builtin_bswap32(value);
+#else
+        return value;
+#endif
+    }
+};
+
+#endif // MEMORY_ACCESS_H
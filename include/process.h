@@ -1,79 +1,235 @@
 #ifndef CPU_CORE_H
 #define CPU_CORE_H
 
+#include "bus.h"
+#include "coherence.h"
+#include "cosim.h"
 #include "cpu_state.h"
 #include "instruction.h"
+#include "memory_access.h"
+#include "profiler.h"
+#include "stage_timer.h"
+#include "syscall_handler.h"
 
 #include <cstdint>
 
-// CPU核心处理器
-class CPU {
+// CPU统计信息，检查点中按原样保存
+struct CPU_Stats {
+    uint64_t cycles;
+    uint64_t instructions;
+    uint64_t branch_mispredictions;
+};
+
+// CPU核心处理器，结构参数由Config在编译期确定，预先实例化的配置见core_config.h
+template <CoreConfig Config> class BasicCPU {
   public:
-    CPU();
-    ~CPU() = default;
+    using Core = BasicCore<Config>;
+
+    BasicCPU();
+    ~BasicCPU() = default;
 
-    // 主执行函数
-    void tick(CPU_State &cpu);
+    // 主执行函数；多核模拟时各hart有各自的core，共享memory
+    void tick(Core &core, uint8_t memory[]);
 
     // 获取统计信息
     uint64_t get_cycle_count() const { return cycle_count_; }
     uint64_t get_instruction_count() const { return instruction_count_; }
     uint64_t get_branch_mispredictions() const { return branch_mispredictions_; }
+    // 重命名时消除并已提交的复制与常数指令数，只有Config.rename_elimination时不为0
+    uint64_t get_moves_eliminated() const { return moves_eliminated_; }
+    uint64_t get_constants_eliminated() const { return constants_eliminated_; }
+    // 提交的各类融合指令对数
+    uint64_t get_fused_pairs(FusionKind kind) const {
+        return fused_pairs_[static_cast<uint32_t>(kind)];
+    }
+
+    CPU_Stats get_stats() const;
+    void set_stats(const CPU_Stats &stats);
+
+    // 提交时引发的异常，cause为None表示没有
+    const ExceptionRecord &get_exception() const { return exception_; }
+
+    // ROB头部是WFI且没有等待处理的中断，此后的周期在中断到来前没有任何进展
+    bool is_waiting() const { return waiting_; }
+    // 跳过n个空闲周期，只增加周期数
+    void skip_cycles(const Core &core, uint64_t n);
+
+    // 下一条待提交指令的地址，即当前架构状态对应的pc
+    static uint32_t architectural_pc(const Core &core);
+    // 丢弃流水线中所有未提交指令，只保留pc、寄存器值，用于切换到功能模型
+    static void flush_to_architectural_state(Core &core) { load_architectural_state(core, core); }
+    // 用另一配置的核的架构状态（pc、寄存器值、CSR、保留）初始化一个空流水线
+    template <CoreConfig Other>
+    static void load_architectural_state(Core &core, const BasicCore<Other> &from) {
+        Core clean;
+        clean.pc = BasicCPU<Other>::architectural_pc(from);
+        clean.csr = from.csr;
+        clean.reservation_valid = from.reservation_valid;
+        clean.reservation_address = from.reservation_address;
+        for (int i = 0; i < 32; ++i) {
+            clean.Regs.reg[i].value = from.Regs.reg[i].value;
+        }
+        clean.restore_rename_map();
+        core = clean;
+    }
+
+    // 挂接热点分析器，传入nullptr关闭
+    void set_profiler(HotspotProfiler *profiler) { profiler_ = profiler; }
+
+    // 挂接系统调用处理，未挂接时ECALL不产生任何效果
+    void set_syscall_handler(SyscallHandler *syscalls) { syscalls_ = syscalls; }
+
+    // 挂接设备总线，未挂接时RAM以外的访存读出0、写入被丢弃
+    void set_bus(Bus *bus) { bus_ = bus; }
+
+    void set_misaligned_policy(MisalignedPolicy policy) { misaligned_policy_ = policy; }
+
+    // 译码时把相邻的lui+addi、auipc+jalr、slli+srli融合为一个ROB条目，默认关闭
+    void set_macro_fusion(bool enabled) { macro_fusion_ = enabled; }
+
+    // 挂接多核一致性目录，未挂接（单核）时访存没有一致性开销
+    void set_coherence(CoherenceDirectory *coherence) { coherence_ = coherence; }
+
+    // 挂接差分检查器，每条指令提交时与参考模型比较
+    void set_checker(CosimChecker *checker) { checker_ = checker; }
+
+    // 各阶段累计的宿主机时间，只有以SIM_STAGE_TIMERS构建时才有数据
+    const StageTimers &get_stage_timers() const { return stage_timers_; }
 
   private:
-    void commit_stage(const CPU_Core &now_state, CPU_Core &next_state, uint8_t memory[]);
-    void writeback_stage(const CPU_Core &now_state, CPU_Core &next_state);
-    void execute_stage(const CPU_Core &now_state, CPU_Core &next_state,
+    static constexpr uint32_t ROB_SIZE = Config.rob_size;
+    static constexpr uint32_t RS_SIZE = Config.rs_size;
+    static constexpr uint32_t LSB_SIZE = Config.lsb_size;
+    static constexpr uint32_t FETCH_BUFFER_SIZE = Config.fetch_buffer_size;
+    static constexpr uint32_t MAX_ALU_UNITS = Config.alu_units;
+    static constexpr uint32_t MAX_LOAD_UNITS = Config.load_units;
+    static constexpr uint32_t MAX_MUL_UNITS = Config.mul_units;
+    static constexpr uint32_t MAX_DIV_UNITS = Config.div_units;
+    static constexpr uint32_t PHYS_REGS = Config.phys_regs; // 0表示没有物理寄存器堆
+
+    void commit_stage(const Core &now_state, Core &next_state, uint8_t memory[]);
+    void writeback_stage(const Core &now_state, Core &next_state);
+    void execute_stage(const Core &now_state, Core &next_state,
                        const uint8_t memory[]);
-    void dispatch_stage(const CPU_Core &now_state, CPU_Core &next_state);
-    void decode_rename_stage(const CPU_Core &now_state, CPU_Core &next_state,
+    // 预译码缓存，按pc直接映射，保存展开后的压缩指令与解码结果
+    const Instruction &predecode(uint32_t raw, uint32_t pc);
+
+    void execute_muldiv(const Core &now_state, Core &next_state);
+    void dispatch_stage(const Core &now_state, Core &next_state);
+    void decode_rename_stage(const Core &now_state, Core &next_state,
                              const uint8_t memory[]);
-    void fetch_stage(const CPU_Core &now_state, CPU_Core &next_state,
+    void fetch_stage(const Core &now_state, Core &next_state,
                      const uint8_t memory[]);
 
+    // 多核时读共享内存持内存锁的共享锁，单核时不加锁
+    std::shared_lock<std::shared_mutex> lock_memory_shared() const {
+        return coherence_ ? std::shared_lock<std::shared_mutex>(coherence_->memory_lock())
+                          : std::shared_lock<std::shared_mutex>();
+    }
+
+    // 在提交阶段执行RV32A指令，返回false表示引发了异常
+    bool commit_atomic(const Core &now_state, Core &next_state, uint8_t memory[]);
+
+    // 在提交阶段引发ROB头部指令的异常并停止取指
+    void raise_exception(Core &next_state, const ROBEntry &entry, ExceptionCause cause);
+
+    // 在pc处（ROB头部指令之前）响应中断，cause为mcause的值
+    void take_interrupt(const Core &now_state, Core &next_state, uint32_t cause,
+                        uint32_t pc);
+    // ROB头部指令之前能否响应中断：WFI要先提交，已经读过的Load（可能是设备读）也要先提交
+    static bool interruptible(const ROBEntry &head, InstrState state);
+
+    // 差分检查，store为nullptr表示非Store指令
+    void check_commit(const Core &now_state, const ROBEntry &entry, const LSBEntry *store);
+
     // ROB管理
-    bool rob_full(const CPU_Core &cpu) const;
-    bool rob_empty(const CPU_Core &cpu) const;
-    uint32_t allocate_rob_entry(CPU_Core &cpu);
-    void free_rob_entry(CPU_Core &cpu);
+    bool rob_full(const Core &cpu) const;
+    bool rob_empty(const Core &cpu) const;
+    uint32_t allocate_rob_entry(Core &cpu);
+    void free_rob_entry(Core &cpu);
 
     // 预约站管理
-    bool rs_available(const CPU_Core &cpu, InstrType type) const;
-    uint32_t allocate_rs_entry(const CPU_Core &cpu, InstrType type);
-    void free_rs_entry(CPU_Core &cpu, uint32_t rs_idx, InstrType type);
+    // 占用且操作数都就绪的条目位图
+    static uint64_t ready_entries(const Core &cpu);
+    bool rs_available(const Core &cpu, InstrType type) const;
+    uint32_t allocate_rs_entry(const Core &cpu, InstrType type);
+    void free_rs_entry(Core &cpu, uint32_t rs_idx, InstrType type);
 
     // LSB管理
-    bool LSB_available(const CPU_Core &cpu) const;
-    uint32_t allocate_LSB_entry(const CPU_Core &cpu);
-    void free_LSB_entry(CPU_Core &cpu, uint32_t LSB_idx);
+    bool LSB_available(const Core &cpu) const;
+    uint32_t allocate_LSB_entry(const Core &cpu);
+    void free_LSB_entry(Core &cpu, uint32_t LSB_idx);
 
     // 寄存器重命名
-    void rename_registers(CPU_Core &cpu, const ROBEntry &rob_entry, uint32_t rob_idx);
-    uint32_t read_operand(const CPU_Core &cpu, uint32_t reg_idx, uint32_t &rob_dependency,
+    void rename_registers(Core &cpu, const ROBEntry &rob_entry, uint32_t rob_idx);
+    uint32_t read_operand(const Core &cpu, uint32_t reg_idx, RobTag &rob_dependency,
                           bool &ready);
+    // 物理寄存器堆模式下译码时写目标物理寄存器的指令
+    static bool writes_register(InstrType type);
+    // 物理寄存器堆模式：查映射表得到源物理寄存器，为目标寄存器从空闲列表分配物理寄存器；
+    // rob_entry.idiom为Move时目标寄存器共享source的物理寄存器，为Constant时直接写入constant
+    void rename_physical(Core &cpu, ROBEntry &rob_entry, uint32_t source, uint32_t constant);
+    // 提交时更新提交映射表，释放目标寄存器原来的物理寄存器
+    void retire_physical(Core &cpu, const ROBEntry &rob_entry);
+    // 分派时读取源操作数reg_idx，物理寄存器堆模式下读phys，本周期写回的值已在next_state中
+    uint32_t read_source(const Core &cpu, const Core &next_state, uint32_t reg_idx, RobTag phys,
+                         RobTag &dependency, bool &ready);
+    // 标签为tag的结果是否已经产生，产生时由value返回
+    bool result_ready(const Core &cpu, RobTag tag, uint32_t &value) const;
 
     // 广播
-    void Broadcast(CPU_Core &cpu, const CDB);
-    void broadcast_result(const CPU_Core &cpu, CPU_Core &next_state, uint32_t rob_idx,
-                          uint32_t value);
+    // 把CDB上本周期的全部结果送给等待它们的预约站与LSB条目
+    void broadcast_results(const Core &cpu, Core &next_state, const CDB &cdb);
 
     // 内存依赖检查
-    bool is_earlier_instruction(const CPU_Core &cpu, uint32_t rob_idx1, uint32_t rob_idx2);
+    bool is_earlier_instruction(const Core &cpu, uint32_t rob_idx1, uint32_t rob_idx2);
 
-    bool check_load_dependencies(const CPU_Core &cpu, uint32_t load_addr, uint32_t load_rob_idx,
-                                 uint32_t &forwarded_value);
-    bool get_load_values(const CPU_Core &cpu, uint32_t load_addr, uint32_t load_rob_idx,
-                         uint32_t &forwarded_value);
+    // 与Load字节范围重叠的最年轻的更早Store，没有时返回LSB_SIZE；
+    // 存在地址未知的更早Store时unknown置为true
+    uint32_t find_older_store(const Core &cpu, const LSBEntry &load, bool &unknown);
+    // 没有可能重叠的更早Store，可以直接读内存
+    bool check_load_dependencies(const Core &cpu, const LSBEntry &load);
+    // 更早的Store完整覆盖Load且数据就绪，可以直接转发
+    bool get_load_values(const Core &cpu, const LSBEntry &load, uint32_t &forwarded_value);
 
     // 分支预测和处理
-    bool predict_branch_taken(const CPU_Core &cpu);
-    void handle_branch_misprediction(CPU_Core &cpu, uint32_t correct_pc);
-    void flush_pipeline(CPU_Core &cpu);
+    bool predict_branch_taken(const Core &cpu);
+    void handle_branch_misprediction(Core &cpu, uint32_t correct_pc);
+    void flush_pipeline(Core &cpu);
+    // 串行化指令提交后冲刷流水线，从next_pc重新取指
+    void serialize_pipeline(Core &cpu, uint32_t next_pc);
 
     // 统计信息
     uint64_t cycle_count_;
-    uint64_t instruction_count_;
+    uint64_t instruction_count_; // 已提交指令数
     uint64_t branch_mispredictions_; // 分支预测错误计数
+    uint64_t moves_eliminated_;
+    uint64_t constants_eliminated_;
+    uint64_t fused_pairs_[FUSION_KINDS];
+    ExceptionRecord exception_;
+    bool waiting_;
+
+    struct PredecodeEntry {
+        bool valid;
+        uint32_t fetched; // 取指得到的原始编码
+        Instruction instr;
+
+        PredecodeEntry() : valid(false), fetched(0) {}
+    };
+    static const uint32_t PREDECODE_CACHE_SIZE = 1024;
+    PredecodeEntry predecode_cache_[PREDECODE_CACHE_SIZE];
+
+    HotspotProfiler *profiler_;
+    CosimChecker *checker_;
+    SyscallHandler *syscalls_;
+    Bus *bus_;
+    CoherenceDirectory *coherence_;
+    MisalignedPolicy misaligned_policy_;
+    bool macro_fusion_;
+
+    StageTimers stage_timers_;
 };
 
+using CPU = BasicCPU<BASE_CORE>;
+
 #endif // CPU_CORE_H
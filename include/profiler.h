@@ -0,0 +1,62 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "cpu_state.h"
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// 按PC统计的热点分析器
+// 以ROB头部指令为归属对象，统计提交停顿周期、分支预测错误和Load延迟
+class HotspotProfiler {
+  public:
+    // 单条指令的统计数据
+    struct Entry {
+        uint32_t pc;
+        bool used;
+        uint64_t commits;        // 提交次数
+        uint64_t stall_cycles;   // 位于ROB头部但未能提交的周期数
+        uint64_t mispredictions; // 提交时发现分支预测错误的次数
+        uint64_t flushes;        // 串行化、陷入或中断引起的其他冲刷次数
+        uint64_t loads;          // 已提交的Load次数
+        uint64_t load_cycles;    // Load从分派到写回的累计周期
+
+        Entry()
+            : pc(0), used(false), commits(0), stall_cycles(0), mispredictions(0), flushes(0),
+              loads(0), load_cycles(0) {}
+    };
+
+    // text_begin/text_end 为程序映像的地址范围，用于确定哈希表容量
+    HotspotProfiler(uint32_t text_begin, uint32_t text_end);
+
+    // 每周期调用一次，比较前后两个状态得出本周期的归属；mispredicted表示本周期提交的
+    // 分支预测错误，用于与其他原因的冲刷区分
+    template <CoreConfig Config>
+    void sample(const BasicCore<Config> &now_state, const BasicCore<Config> &next_state,
+                uint64_t cycle, bool mispredicted);
+
+    // 跳过的空闲周期（WFI等待），计为ROB头部指令的停顿
+    template <CoreConfig Config> void skip(const BasicCore<Config> &state, uint64_t cycles);
+
+    // 输出按开销排序的报告，memory用于反汇编
+    void write_report(std::ostream &out, const uint8_t memory[]) const;
+
+  private:
+    Entry &lookup(uint32_t pc);
+    void grow();
+
+    std::vector<Entry> table_; // 开放寻址哈希表，容量为2的幂
+    uint32_t mask_;
+    uint32_t used_;
+
+    // 按ROB槽位记录的Load分派/完成周期
+    uint64_t load_start_[MAX_ROB_SIZE];
+    uint64_t load_latency_[MAX_ROB_SIZE];
+
+    uint64_t total_cycles_;
+    uint64_t flush_cycles_; // 流水线冲刷后的空转周期
+    uint64_t empty_cycles_; // ROB为空的周期
+};
+
+#endif // PROFILER_H
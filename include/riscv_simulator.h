@@ -1,28 +1,126 @@
 #ifndef RISCV_SIMULATOR_H
 #define RISCV_SIMULATOR_H
 
+#include "cosim.h"
 #include "cpu_state.h"
+#include "devices.h"
+#include "event_queue.h"
 #include "process.h"
+#include "profiler.h"
+#include "syscall_handler.h"
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
 
 class CPUCore;
 
+// run() 的返回值，作为进程退出码
+enum SimExitStatus {
+    SIM_EXIT_OK = 0,
+    SIM_EXIT_COSIM_MISMATCH = 3, // 差分检查发现流水线与参考模型不一致
+    SIM_EXIT_EXCEPTION = 4,      // 客户程序引发了异常（非法指令、取指越界）
+    SIM_EXIT_DEADLOCK = 5,       // WFI等待时没有任何待处理的事件，程序不会再前进
+};
+
+// 模拟器运行选项
+struct SimConfig {
+    std::string profile_path; // 热点分析报告输出路径，为空则不启用
+    bool cosim;               // 每次提交与功能模型锁步比较
+    bool stats;               // 结束时输出x10与周期、指令统计（多核时为0号hart，另外总是输出各hart的统计）
+    std::string input_path;   // 客户程序标准输入，为空则使用程序映像之后的标准输入
+    MisalignedPolicy misaligned; // 非对齐访存的处理方式
+
+    // 检查点
+    std::string checkpoint_path;  // 检查点输出路径
+    uint64_t checkpoint_at;       // 运行到该周期时保存检查点并退出，0表示不启用
+    uint64_t checkpoint_interval; // 每隔该周期数覆盖保存一次检查点，0表示不启用
+
+    // 采样模拟：功能模型快进，乱序模型预热并测量
+    uint64_t sample_interval;         // 采样周期（指令数）；SimPoint模式下为区间长度
+    uint64_t sample_warmup;           // 每次测量前的预热指令数
+    uint64_t sample_window;           // 每次测量的指令数
+    std::string simpoint_path;        // SimPoint区间文件，每行 "<区间号> <类号>"
+    std::string simpoint_weight_path; // SimPoint权重文件，每行 "<权重> <类号>"
+
+    // 多核：每个hart一条乱序流水线，在各自的宿主线程上运行，
+    // 每quantum个周期在屏障处同步一次，hart之间的时间偏差不超过一个quantum
+    uint32_t harts;
+    uint64_t quantum;
+
+    // 乱序核的结构配置，BASE以外的配置只支持单核、不支持检查点与采样
+    CoreKind core;
+    bool fusion; // 译码时融合相邻的常见指令对
+
+    // 基本块向量统计（使用功能模型运行整个程序）
+    std::string bbv_path;  // .bb文件输出路径，为空则不启用
+    uint64_t bbv_interval; // 区间长度（指令数）
+
+    SimConfig()
+        : cosim(false), stats(false), misaligned(MisalignedPolicy::Emulate), checkpoint_at(0),
+          checkpoint_interval(0), sample_interval(0), sample_warmup(0), sample_window(0),
+          harts(1), quantum(1000), core(CoreKind::Base), fusion(false), bbv_interval(100000000) {}
+};
+
 class RISCV_Simulator {
   private:
     CPU_State cpu;  // cpu具体信息
     bool is_halted; //是否停机
+    bool deadlocked; // WFI时事件队列为空而停机
     CPU *cpu_core;  // cpu的核心步骤
+    CosimChecker *checker; // 差分检查器，未启用时为nullptr
+
+    SimConfig config;
+    uint32_t image_begin; // 程序映像的最低地址
+    uint32_t image_end;   // 程序映像的最高地址+1
+    uint32_t program_break;    // 系统调用维护的堆顶，初始为映像末尾
+    ClintState clint_state;    // 运行开始时CLINT的寄存器，从检查点恢复时不是初始值
+    SyscallHandler *syscalls; // 运行期间有效
+    Bus *bus;                 // 设备总线，运行期间有效
+    EventQueue *events;       // 设备登记的定时事件，运行期间有效
+    std::atomic<uint64_t> global_time; // 多核模拟时已同步到的周期，即CLINT的mtime；
+                                       // 使用BASE以外的配置时为该配置的核的周期数
+    ExceptionRecord exception; // 结束运行的异常
 
   public:
-    RISCV_Simulator();
+    RISCV_Simulator(const SimConfig &config = SimConfig());
     ~RISCV_Simulator();
 
     void load_program(); // 读取指令
-    void run();          // 运行主程序
+    bool restore_checkpoint(const std::string &path); // 从检查点恢复，代替load_program
+    int run();           // 运行主程序，返回SimExitStatus
+
+    // 0号hart的统计，run() 之后有效
+    uint64_t get_cycle_count() const { return cpu_core->get_cycle_count(); }
+    uint64_t get_instruction_count() const { return cpu_core->get_instruction_count(); }
 
   private:
+    // 一次详细模拟的测量结果
+    struct SampleWindow {
+        uint64_t instructions;
+        uint64_t cycles;
+        double weight;
+    };
+
+    void run_sampled();                                  // 采样模式主循环
+    void run_bbv();                                      // 功能模型运行并统计基本块向量
+    void run_multihart();                                // 多核并行模拟
+    template <CoreConfig Config>
+    void run_core(HotspotProfiler *profiler);            // 用Config配置的核运行到停机
+    uint64_t run_detailed(uint64_t count);               // 乱序模型提交count条指令，返回周期数
+    bool read_simpoints(std::vector<std::pair<uint64_t, double>> &points);
+    void report_samples(const std::vector<SampleWindow> &windows, uint64_t total_instructions);
+
     void tick();                  //模拟cpu每一秒操作
+    void skip_idle_cycles();      // WFI等待时直接跳到下一个事件
+    uint64_t idle_target(uint64_t cycle); // 空闲等待应跳到的周期，没有事件时记为死锁并停机
     uint32_t fetch_instruction(); //读取指令
     void print_result();          //输出结果
+    void print_stats();           // 输出x10与周期、指令统计
+    template <CoreConfig Config>
+    void print_core_stats(const BasicCPU<Config> &model); // 输出重命名消除与指令融合的计数
+    void report_exception();      //输出异常信息
 };
 
 #endif
@@ -0,0 +1,61 @@
+#ifndef STAGE_TIMER_H
+#define STAGE_TIMER_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// 按流水线阶段累计宿主机时间，用于判断模拟器自身的热点
+// 只有以 -DSIM_STAGE_TIMERS=ON 构建时才插桩，否则 STAGE_TIMER 展开为空
+
+enum class PipelineStage { Commit, Writeback, Execute, Dispatch, Decode, Fetch, Tick, Count };
+
+class StageTimers {
+  public:
+    StageTimers();
+
+    // x86上读时间戳计数器，其他平台退化为steady_clock的纳秒数
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    void add(PipelineStage stage, uint64_t ticks) { ticks_[static_cast<int>(stage)] += ticks; }
+    void merge(const StageTimers &other);
+
+    // 用构造以来计数器与steady_clock的增量把计数换算为纳秒，cycles为模拟周期数
+    void report(std::ostream &out, uint64_t cycles) const;
+
+  private:
+    uint64_t ticks_[static_cast<int>(PipelineStage::Count)];
+    uint64_t start_ticks_;
+    std::chrono::steady_clock::time_point start_time_;
+};
+
+// 作用域结束时把经过的计数记到对应阶段
+class ScopedStageTimer {
+  public:
+    ScopedStageTimer(StageTimers &timers, PipelineStage stage)
+        : timers_(timers), stage_(stage), start_(StageTimers::now()) {}
+    ~ScopedStageTimer() { timers_.add(stage_, StageTimers::now() - start_); }
+
+  private:
+    StageTimers &timers_;
+    PipelineStage stage_;
+    uint64_t start_;
+};
+
+#ifdef SIM_STAGE_TIMERS
+#define STAGE_TIMER(timers, stage) ScopedStageTimer stage_timer_(timers, stage)
+#else
+#define STAGE_TIMER(timers, stage) ((void)0)
+#endif
+
+#endif // STAGE_TIMER_H
@@ -0,0 +1,50 @@
+#ifndef STREAM_GENERATOR_H
+#define STREAM_GENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// 合成指令流的参数
+// 循环体由body_length个槽组成，每个槽按mix权重随机选择一类：
+//   ALU：一条R/I型运算；Load/Store：以x8为基址的字访问；
+//   分支：slli取伪随机数的不同位与阈值比较，bltu跳过其后的一条ALU指令
+struct StreamConfig {
+    uint32_t body_length;         // 循环体槽数
+    uint32_t iterations;          // 循环次数
+    uint32_t dependency_distance; // 每条指令读取dependency_distance条之前的结果（1..19）
+    double branch_bias;           // 条件分支跳转的概率
+    double alias_rate;            // Load读取此前Store写过的地址的比例
+    double alu_weight, branch_weight, load_weight, store_weight;
+    uint64_t seed;
+
+    StreamConfig()
+        : body_length(256), iterations(1000), dependency_distance(4), branch_bias(0.5),
+          alias_rate(0.5), alu_weight(0.6), branch_weight(0.15), load_weight(0.15),
+          store_weight(0.1), seed(1) {}
+};
+
+// 生成结果：从地址0开始的代码与data_base处的数据，以及参考模型算出的结果
+struct GeneratedStream {
+    std::vector<uint32_t> code;
+    uint32_t data_base;
+    std::vector<uint32_t> data;
+    uint32_t checksum;     // 停机时的x10
+    uint64_t instructions; // 动态指令数，不含停机指令
+};
+
+// 生成只含RV32I指令的合成程序，最终x10为xorshift状态与所有工作寄存器的异或
+class StreamGenerator {
+  public:
+    static const uint32_t MAX_DEPENDENCY_DISTANCE = 19;
+    static const uint32_t MAX_BODY_LENGTH = 32768;
+
+    // run_reference为false时不运行参考模型，checksum与instructions为0，
+    // 用于循环次数很大、只作为性能负载的程序
+    static GeneratedStream generate(const StreamConfig &config, bool run_reference = true);
+
+    // 以load_program读取的 "@地址" + 十六进制字节格式输出
+    static void write_image(std::ostream &out, const GeneratedStream &stream);
+};
+
+#endif // STREAM_GENERATOR_H
@@ -0,0 +1,60 @@
+#ifndef SYSCALL_HANDLER_H
+#define SYSCALL_HANDLER_H
+
+#include "cpu_state.h"
+
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <string>
+
+// newlib/Linux RISC-V 系统调用号
+const uint32_t SYS_CLOSE = 57;
+const uint32_t SYS_READ = 63;
+const uint32_t SYS_WRITE = 64;
+const uint32_t SYS_FSTAT = 80;
+const uint32_t SYS_EXIT = 93;
+const uint32_t SYS_EXIT_GROUP = 94;
+const uint32_t SYS_BRK = 214;
+
+// ECALL的宿主机实现：a7为调用号，a0-a2为参数，返回值写入a0
+// 输出先写入缓冲区，缓冲区满、读输入前以及程序结束时才写到宿主机
+// 多核模拟时各hart在不同线程调用，公开接口都在同一把（可重入）锁内执行
+class SyscallHandler {
+  public:
+    // input为客户程序的标准输入，heap_start为初始的program break
+    SyscallHandler(std::istream &input, uint32_t heap_start);
+    ~SyscallHandler();
+
+    // 执行一次系统调用，只修改regs中的a0和memory
+    void handle(Registers &regs, uint8_t memory[]);
+
+    uint32_t get_program_break() const { return brk_; }
+
+    bool has_exited() const { return exited_; }
+    uint32_t get_exit_code() const { return exit_code_; }
+
+    // 控制台收发，供write/read系统调用与串口设备共用
+    void write_console(uint32_t fd, const char *data, size_t size);
+    bool read_console(char &c); // 输入结束时返回false
+    bool console_ready();       // 是否有可读的输入
+
+    void flush();
+
+  private:
+    uint32_t sys_write(uint32_t fd, uint32_t buf, uint32_t count, const uint8_t memory[]);
+    uint32_t sys_read(uint32_t fd, uint32_t buf, uint32_t count, uint8_t memory[]);
+    uint32_t sys_brk(uint32_t addr);
+
+    static const size_t OUTPUT_BUFFER_SIZE = 4096;
+
+    std::recursive_mutex lock_;
+    std::istream &input_;
+    std::string stdout_buffer_;
+    std::string stderr_buffer_;
+    uint32_t brk_;
+    bool exited_;
+    uint32_t exit_code_;
+};
+
+#endif // SYSCALL_HANDLER_H
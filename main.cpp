@@ -1,18 +1,167 @@
 #include "include/riscv_simulator.h"
 
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 int cnt = 0;
 
-int main() {
+static void print_usage(const char *prog) {
+    std::cerr << "Usage: " << prog << " [options] < program.data\n"
+              << "  --profile <file>             write per-PC hotspot report to <file>\n"
+              << "  --cosim                      check every commit against a functional model\n"
+              << "  --stats                      print x10, cycles and instructions at exit\n"
+              << "  --input <file>               guest standard input for the read syscall\n"
+              << "  --misaligned <emulate|trap>  misaligned load/store handling (emulate)\n"
+              << "  --harts <n>                  simulate <n> harts sharing memory (1)\n"
+              << "  --quantum <cycles>           hart synchronization interval (1000)\n"
+              << "  --core <base|medium|large|prf>\n"
+              << "                               out-of-order core configuration (base)\n"
+              << "  --fusion                     fuse lui+addi, auipc+jalr and slli+srli pairs\n"
+              << "  --save-checkpoint <file>     checkpoint file to write\n"
+              << "  --checkpoint-at <cycle>      save checkpoint at <cycle> and exit\n"
+              << "  --checkpoint-interval <n>    save checkpoint every <n> cycles\n"
+              << "  --restore-checkpoint <file>  resume from <file> instead of reading stdin\n"
+              << "  --sample-interval <n>        sampled simulation: one window every <n> insts\n"
+              << "  --sample-warmup <n>          detailed warmup instructions per window\n"
+              << "  --sample-window <n>          detailed measured instructions per window\n"
+              << "  --simpoints <file>           measure the SimPoint intervals in <file>,\n"
+              << "                               <n> of --sample-interval is the interval size\n"
+              << "  --simpoint-weights <file>    weights matching --simpoints\n"
+              << "  --bbv <file>                 write SimPoint basic-block vectors to <file>\n"
+              << "  --bbv-interval <n>           instructions per BBV interval (100000000)\n";
+}
+
+static bool parse_arguments(int argc, char *argv[], SimConfig &config,
+                            std::string &restore_path) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            config.profile_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--cosim") == 0) {
+            config.cosim = true;
+        } else if (std::strcmp(argv[i], "--stats") == 0) {
+            config.stats = true;
+        } else if (std::strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+            config.input_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--misaligned") == 0 && i + 1 < argc) {
+            ++i;
+            if (std::strcmp(argv[i], "trap") == 0) {
+                config.misaligned = MisalignedPolicy::Trap;
+            } else if (std::strcmp(argv[i], "emulate") == 0) {
+                config.misaligned = MisalignedPolicy::Emulate;
+            } else {
+                print_usage(argv[0]);
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--harts") == 0 && i + 1 < argc) {
+            config.harts = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (std::strcmp(argv[i], "--quantum") == 0 && i + 1 < argc) {
+            config.quantum = std::strtoull(argv[++i], nullptr, 0);
+        } else if (std::strcmp(argv[i], "--core") == 0 && i + 1 < argc) {
+            ++i;
+            if (std::strcmp(argv[i], "base") == 0) {
+                config.core = CoreKind::Base;
+            } else if (std::strcmp(argv[i], "medium") == 0) {
+                config.core = CoreKind::Medium;
+            } else if (std::strcmp(argv[i], "large") == 0) {
+                config.core = CoreKind::Large;
+            } else if (std::strcmp(argv[i], "prf") == 0) {
+                config.core = CoreKind::Prf;
+            } else {
+                print_usage(argv[0]);
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--fusion") == 0) {
+            config.fusion = true;
+        } else if (std::strcmp(argv[i], "--save-checkpoint") == 0 && i + 1 < argc) {
+            config.checkpoint_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--checkpoint-at") == 0 && i + 1 < argc) {
+            config.checkpoint_at = std::strtoull(argv[++i], nullptr, 0);
+        } else if (std::strcmp(argv[i], "--checkpoint-interval") == 0 && i + 1 < argc) {
+            config.checkpoint_interval = std::strtoull(argv[++i], nullptr, 0);
+        } else if (std::strcmp(argv[i], "--restore-checkpoint") == 0 && i + 1 < argc) {
+            restore_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--sample-interval") == 0 && i + 1 < argc) {
+            config.sample_interval = std::strtoull(argv[++i], nullptr, 0);
+        } else if (std::strcmp(argv[i], "--sample-warmup") == 0 && i + 1 < argc) {
+            config.sample_warmup = std::strtoull(argv[++i], nullptr, 0);
+        } else if (std::strcmp(argv[i], "--sample-window") == 0 && i + 1 < argc) {
+            config.sample_window = std::strtoull(argv[++i], nullptr, 0);
+        } else if (std::strcmp(argv[i], "--simpoints") == 0 && i + 1 < argc) {
+            config.simpoint_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--simpoint-weights") == 0 && i + 1 < argc) {
+            config.simpoint_weight_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--bbv") == 0 && i + 1 < argc) {
+            config.bbv_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--bbv-interval") == 0 && i + 1 < argc) {
+            config.bbv_interval = std::strtoull(argv[++i], nullptr, 0);
+        } else {
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    if (!config.bbv_path.empty() && config.bbv_interval == 0) {
+        std::cerr << "--bbv-interval must be positive" << std::endl;
+        return false;
+    }
+    if (!config.simpoint_path.empty() && config.sample_interval == 0) {
+        std::cerr << "--simpoints requires --sample-interval" << std::endl;
+        return false;
+    }
+    if (config.sample_interval && config.simpoint_path.empty() && config.sample_window == 0) {
+        std::cerr << "--sample-interval requires --sample-window" << std::endl;
+        return false;
+    }
+    if (config.stats && (config.sample_interval || !config.bbv_path.empty())) {
+        std::cerr << "--stats cannot be combined with sampling or --bbv" << std::endl;
+        return false;
+    }
+    if (config.cosim && (config.sample_interval || !config.bbv_path.empty())) {
+        // 功能模型执行的部分没有提交记录，参考模型无法跟上
+        std::cerr << "--cosim cannot be combined with sampling or --bbv" << std::endl;
+        return false;
+    }
+    if (config.harts == 0 || config.harts > MAX_HARTS || config.quantum == 0) {
+        std::cerr << "--harts must be 1.." << MAX_HARTS << " and --quantum positive" << std::endl;
+        return false;
+    }
+    if (config.harts > 1 &&
+        (config.cosim || !config.profile_path.empty() || !config.checkpoint_path.empty() ||
+         !restore_path.empty() || config.sample_interval || !config.bbv_path.empty())) {
+        std::cerr << "--harts cannot be combined with cosim, profiling, checkpoints or sampling"
+                  << std::endl;
+        return false;
+    }
+    if (config.core != CoreKind::Base &&
+        (config.harts > 1 || !config.checkpoint_path.empty() || !restore_path.empty() ||
+         config.sample_interval || !config.bbv_path.empty())) {
+        std::cerr << "--core medium|large|prf cannot be combined with --harts, checkpoints or "
+                     "sampling"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
     std::ios_base::sync_with_stdio(false);
     std::cin.tie(NULL);
 
-    RISCV_Simulator simulator;
+    SimConfig config;
+    std::string restore_path;
+    if (!parse_arguments(argc, argv, config, restore_path)) {
+        return 2;
+    }
 
-    simulator.load_program();
+    RISCV_Simulator simulator(config);
 
-    simulator.run();
+    if (!restore_path.empty()) {
+        if (!simulator.restore_checkpoint(restore_path)) {
+            return 1;
+        }
+    } else {
+        simulator.load_program();
+    }
 
-    return 0;
+    return simulator.run();
 }
@@ -0,0 +1,57 @@
+#include "../include/bbv_profiler.h"
+
+#include <algorithm>
+
+BBVProfiler::BBVProfiler(std::ostream &out, uint64_t interval)
+    : out_(out), interval_(interval), block_start_(0), block_length_(0), counts_(1),
+      interval_instructions_(0), interval_count_(0) {}
+
+void BBVProfiler::end_block() {
+    auto it = block_ids_.find(block_start_);
+    uint32_t id;
+    if (it == block_ids_.end()) {
+        id = counts_.size();
+        block_ids_.emplace(block_start_, id);
+        counts_.push_back(0);
+    } else {
+        id = it->second;
+    }
+
+    if (counts_[id] == 0) {
+        touched_.push_back(id);
+    }
+    counts_[id] += block_length_;
+    interval_instructions_ += block_length_;
+    block_length_ = 0;
+
+    // 与SimPoint工具一致，只在基本块边界处切分区间
+    if (interval_instructions_ >= interval_) {
+        write_interval();
+    }
+}
+
+void BBVProfiler::write_interval() {
+    std::sort(touched_.begin(), touched_.end());
+    out_ << "T";
+    for (uint32_t id : touched_) {
+        out_ << ":" << id << ":" << counts_[id] << " ";
+        counts_[id] = 0;
+    }
+    out_ << "\n";
+    touched_.clear();
+    interval_instructions_ = 0;
+    ++interval_count_;
+}
+
+void BBVProfiler::finish() {
+    if (block_length_ > 0) {
+        uint64_t saved_interval = interval_;
+        interval_ = UINT64_MAX;
+        end_block();
+        interval_ = saved_interval;
+    }
+    if (interval_instructions_ > 0) {
+        write_interval();
+    }
+    out_.flush();
+}
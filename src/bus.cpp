@@ -0,0 +1,69 @@
+#include "../include/bus.h"
+
+#include <iostream>
+
+Bus::Bus() : exited_(false), exit_code_(0) {
+    for (uint32_t i = 0; i < MAX_HARTS; ++i) {
+        pending_interrupts_[i] = 0;
+    }
+}
+
+bool Bus::attach(uint32_t base, uint32_t size, Device *device) {
+    const uint64_t end = static_cast<uint64_t>(base) + size;
+    if (size == 0 || base < static_cast<uint32_t>(MEMORY_SIZE) || end > (1ull << 32)) {
+        return false;
+    }
+    for (const Mapping &mapping : mappings_) {
+        if (base < static_cast<uint64_t>(mapping.base) + mapping.size && mapping.base < end) {
+            return false;
+        }
+    }
+    mappings_.push_back({base, size, device});
+    return true;
+}
+
+Device *Bus::lookup(uint32_t address, uint32_t size, uint32_t &offset) const {
+    for (const Mapping &mapping : mappings_) {
+        const uint32_t relative = address - mapping.base;
+        if (relative < mapping.size && size <= mapping.size - relative) {
+            offset = relative;
+            return mapping.device;
+        }
+    }
+    return nullptr;
+}
+
+bool Bus::read(uint32_t address, uint32_t size, uint32_t &value) {
+    uint32_t offset;
+    Device *device = lookup(address, size, offset);
+    if (!device) {
+        cerr << "Warning: load from unmapped address 0x" << std::hex << address << std::dec
+             << std::endl;
+        value = 0;
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(lock_);
+    value = device->read(offset, size);
+    if (size < 4) {
+        value &= (1u << (size * 8)) - 1;
+    }
+    return true;
+}
+
+bool Bus::write(uint32_t address, uint32_t size, uint32_t value) {
+    uint32_t offset;
+    Device *device = lookup(address, size, offset);
+    if (!device) {
+        cerr << "Warning: store to unmapped address 0x" << std::hex << address << std::dec
+             << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(lock_);
+    device->write(offset, size, value);
+    return true;
+}
+
+void Bus::request_exit(uint32_t code) {
+    exit_code_ = code;
+    exited_ = true;
+}
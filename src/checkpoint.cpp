@@ -0,0 +1,198 @@
+#include "../include/checkpoint.h"
+
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+static_assert(std::is_trivially_copyable_v<CPU_Core>, "CPU_Core must be plain data");
+static_assert(std::is_trivially_copyable_v<ClintState>, "ClintState must be plain data");
+static_assert(MEMORY_SIZE % CHECKPOINT_PAGE_SIZE == 0, "memory must be page aligned");
+
+namespace {
+
+const char CHECKPOINT_MAGIC[8] = {'R', 'V', 'C', 'K', 'P', 'T', 0, 0};
+const uint32_t FLAG_COMPRESSED = 1;
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t core_size;   // sizeof(CPU_Core)，用于检查配置是否一致
+    uint32_t memory_size; // MEMORY_SIZE
+    uint32_t page_size;
+    uint32_t flags;
+    uint32_t page_count;  // 写入的非零页数
+    uint32_t program_break;
+    uint64_t raw_size;    // 内存页数据未压缩大小
+    uint64_t stored_size; // 内存页数据实际写入大小
+};
+
+bool page_is_zero(const uint8_t *page) {
+    for (uint32_t i = 0; i < CHECKPOINT_PAGE_SIZE; ++i) {
+        if (page[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool save_checkpoint(const std::string &path, const CPU_State &state, const CPU_Stats &stats,
+                     uint32_t program_break, const ClintState &clint) {
+    // 非零页按 [页号][页内容] 顺序排列
+    std::vector<uint8_t> pages;
+    uint32_t page_count = 0;
+    for (uint32_t base = 0; base < MEMORY_SIZE; base += CHECKPOINT_PAGE_SIZE) {
+        if (page_is_zero(&state.memory[base])) {
+            continue;
+        }
+        uint32_t index = base / CHECKPOINT_PAGE_SIZE;
+        const uint8_t *index_bytes = reinterpret_cast<const uint8_t *>(&index);
+        pages.insert(pages.end(), index_bytes, index_bytes + sizeof(index));
+        pages.insert(pages.end(), &state.memory[base], &state.memory[base] + CHECKPOINT_PAGE_SIZE);
+        ++page_count;
+    }
+
+    CheckpointHeader header;
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.core_size = sizeof(CPU_Core);
+    header.memory_size = MEMORY_SIZE;
+    header.page_size = CHECKPOINT_PAGE_SIZE;
+    header.flags = 0;
+    header.page_count = page_count;
+    header.program_break = program_break;
+    header.raw_size = pages.size();
+    header.stored_size = pages.size();
+
+#ifdef HAVE_ZLIB
+    std::vector<uint8_t> compressed(compressBound(pages.size()));
+    uLongf compressed_size = compressed.size();
+    if (compress2(compressed.data(), &compressed_size, pages.data(), pages.size(),
+                  Z_BEST_SPEED) == Z_OK) {
+        compressed.resize(compressed_size);
+        pages.swap(compressed);
+        header.flags |= FLAG_COMPRESSED;
+        header.stored_size = pages.size();
+    }
+#endif
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Error: cannot open checkpoint " << path << " for writing" << std::endl;
+        return false;
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(&stats), sizeof(stats));
+    out.write(reinterpret_cast<const char *>(&state.core), sizeof(state.core));
+    out.write(reinterpret_cast<const char *>(&clint), sizeof(clint));
+    out.write(reinterpret_cast<const char *>(pages.data()), pages.size());
+    if (!out) {
+        std::cerr << "Error: failed to write checkpoint " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool load_checkpoint(const std::string &path, CPU_State &state, CPU_Stats &stats,
+                     uint32_t &program_break, ClintState &clint) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Error: cannot open checkpoint " << path << std::endl;
+        return false;
+    }
+
+    CheckpointHeader header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0) {
+        std::cerr << "Error: " << path << " is not a checkpoint" << std::endl;
+        return false;
+    }
+    if (header.version != CHECKPOINT_VERSION || header.core_size != sizeof(CPU_Core) ||
+        header.memory_size != MEMORY_SIZE || header.page_size != CHECKPOINT_PAGE_SIZE) {
+        std::cerr << "Error: checkpoint " << path << " was written by an incompatible build"
+                  << std::endl;
+        return false;
+    }
+
+    // 按文件头分配缓冲区之前先检查各长度：页数不超过内存页数，未压缩大小与页数一致，
+    // 写入大小不超过文件剩余部分，损坏的文件不会引起过大的分配
+    const uint32_t record_size = sizeof(uint32_t) + CHECKPOINT_PAGE_SIZE;
+    const uint64_t body_begin = static_cast<uint64_t>(in.tellg());
+    in.seekg(0, std::ios::end);
+    const uint64_t file_size = static_cast<uint64_t>(in.tellg());
+    in.seekg(static_cast<std::streamoff>(body_begin));
+    const uint64_t fixed_size = sizeof(CPU_Stats) + sizeof(CPU_Core) + sizeof(ClintState);
+    if (!in || file_size < body_begin + fixed_size) {
+        std::cerr << "Error: checkpoint " << path << " is truncated" << std::endl;
+        return false;
+    }
+    const bool compressed = (header.flags & FLAG_COMPRESSED) != 0;
+    if (header.page_count > MEMORY_SIZE / CHECKPOINT_PAGE_SIZE ||
+        header.raw_size != static_cast<uint64_t>(header.page_count) * record_size ||
+        header.stored_size > file_size - body_begin - fixed_size ||
+        (!compressed && header.stored_size != header.raw_size)) {
+        std::cerr << "Error: checkpoint " << path << " is corrupted" << std::endl;
+        return false;
+    }
+
+    CPU_Stats saved_stats;
+    CPU_Core saved_core;
+    ClintState saved_clint;
+    std::vector<uint8_t> pages(header.stored_size);
+    if (!in.read(reinterpret_cast<char *>(&saved_stats), sizeof(saved_stats)) ||
+        !in.read(reinterpret_cast<char *>(&saved_core), sizeof(saved_core)) ||
+        !in.read(reinterpret_cast<char *>(&saved_clint), sizeof(saved_clint)) ||
+        !in.read(reinterpret_cast<char *>(pages.data()), pages.size())) {
+        std::cerr << "Error: checkpoint " << path << " is truncated" << std::endl;
+        return false;
+    }
+
+    if (compressed) {
+#ifdef HAVE_ZLIB
+        std::vector<uint8_t> raw(header.raw_size);
+        uLongf raw_size = raw.size();
+        if (uncompress(raw.data(), &raw_size, pages.data(), pages.size()) != Z_OK ||
+            raw_size != header.raw_size) {
+            std::cerr << "Error: checkpoint " << path << " is corrupted" << std::endl;
+            return false;
+        }
+        pages.swap(raw);
+#else
+        std::cerr << "Error: checkpoint " << path << " is compressed but zlib is unavailable"
+                  << std::endl;
+        return false;
+#endif
+    }
+
+    if (pages.size() != header.raw_size) {
+        std::cerr << "Error: checkpoint " << path << " is corrupted" << std::endl;
+        return false;
+    }
+    for (uint32_t i = 0; i < header.page_count; ++i) {
+        uint32_t index;
+        std::memcpy(&index, &pages[i * record_size], sizeof(index));
+        if (index >= MEMORY_SIZE / CHECKPOINT_PAGE_SIZE) {
+            std::cerr << "Error: checkpoint " << path << " is corrupted" << std::endl;
+            return false;
+        }
+    }
+
+    std::memset(state.memory, 0, MEMORY_SIZE);
+    for (uint32_t i = 0; i < header.page_count; ++i) {
+        uint32_t index;
+        std::memcpy(&index, &pages[i * record_size], sizeof(index));
+        std::memcpy(&state.memory[index * CHECKPOINT_PAGE_SIZE],
+                    &pages[i * record_size + sizeof(index)], CHECKPOINT_PAGE_SIZE);
+    }
+    state.core = saved_core;
+    stats = saved_stats;
+    clint = saved_clint;
+    program_break = header.program_break;
+    return true;
+}
@@ -0,0 +1,48 @@
+#include "../include/coherence.h"
+
+#include <bit>
+
+CoherenceDirectory::CoherenceDirectory() : invalidations_(0), interventions_(0) {}
+
+uint32_t CoherenceDirectory::access(uint32_t hart, uint32_t address, bool write) {
+    std::lock_guard<std::mutex> guard(lock_);
+    Line &line = lines_[address >> LINE_SHIFT];
+    const uint32_t self = 1u << hart;
+    if (line.owner == static_cast<int32_t>(hart)) {
+        return 0;
+    }
+
+    uint32_t latency = 0;
+    if (!write) {
+        if (line.owner >= 0) {
+            // M -> S，原持有者写回并保留只读副本
+            ++interventions_;
+            line.sharers |= 1u << line.owner;
+            line.owner = -1;
+            latency = TRANSFER_LATENCY;
+        }
+        line.sharers |= self;
+        return latency;
+    }
+
+    uint32_t others = line.sharers & ~self;
+    if (line.owner >= 0) {
+        others |= 1u << line.owner;
+    }
+    if (others) {
+        invalidations_ += std::popcount(others);
+        latency = TRANSFER_LATENCY;
+    }
+    line.sharers = 0;
+    line.owner = static_cast<int32_t>(hart);
+    return latency;
+}
+
+bool CoherenceDirectory::holds(uint32_t hart, uint32_t address) {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto it = lines_.find(address >> LINE_SHIFT);
+    if (it == lines_.end()) {
+        return false;
+    }
+    return it->second.owner == static_cast<int32_t>(hart) || (it->second.sharers & (1u << hart));
+}
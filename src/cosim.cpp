@@ -0,0 +1,155 @@
+#include "../include/cosim.h"
+
+#include "../include/csr.h"
+#include "../include/instruction.h"
+#include "../include/process.h"
+#include "../include/syscall_handler.h"
+
+#include <algorithm>
+#include <iomanip>
+
+CosimChecker::CosimChecker(const CPU_State &initial)
+    : golden_(new CPU_State(initial)), dut_memory_(initial.memory), failed_(false), checked_(0) {
+    // 从检查点恢复时流水线中还有未提交的指令，core.pc是取指地址，参考模型应从下一条待提交的
+    // 指令开始
+    CPU::flush_to_architectural_state(golden_->core);
+}
+
+bool CosimChecker::on_commit(const CommitRecord &record, const Registers &committed,
+                             uint64_t cycle) {
+    if (failed_) {
+        return false;
+    }
+
+    const uint32_t expected_pc = golden_->pc();
+    if (record.pc != expected_pc) {
+        report("pc", record, committed, expected_pc, record.pc, cycle);
+        return false;
+    }
+
+    if (record.type == InstrType::ECALL && !CSRProcessor::traps_enabled(golden_->core.csr)) {
+        // 系统调用的副作用只在流水线一侧执行一次，参考模型直接同步其结果
+        Registers &regs = golden_->Regs();
+        const uint32_t buf = regs.get_value(11);
+        const int32_t got = static_cast<int32_t>(record.value);
+        if (regs.get_value(17) == SYS_READ && got > 0 && buf < MEMORY_SIZE &&
+            static_cast<uint32_t>(got) <= MEMORY_SIZE - buf) {
+            std::copy(dut_memory_ + buf, dut_memory_ + buf + got, golden_->memory + buf);
+        }
+        regs.set_value(10, record.value);
+        golden_->pc() = record.pc + 4;
+        ++checked_;
+        return true;
+    }
+
+    if (!reference_.step(*golden_)) {
+        report("reference model halted, pc", record, committed, expected_pc, record.pc, cycle);
+        return false;
+    }
+
+    const FunctionalCore::StoreAccess &store = reference_.get_last_store();
+    if (record.is_store != store.valid) {
+        report("store committed", record, committed, store.valid, record.is_store, cycle);
+        return false;
+    }
+    if (record.is_store) {
+        const uint32_t size = InstructionProcessor::get_access_size(record.type);
+        const uint32_t mask = size == 4 ? 0xFFFFFFFFu : (1u << (size * 8)) - 1;
+        if (record.store_address != store.address) {
+            report("store address", record, committed, store.address, record.store_address,
+                   cycle);
+            return false;
+        }
+        if ((record.store_value & mask) != (store.value & mask)) {
+            report("store data", record, committed, store.value & mask,
+                   record.store_value & mask, cycle);
+            return false;
+        }
+    } else if (reference_.last_was_device_access() || reads_timing_csr(record)) {
+        // 参考模型不挂接设备、没有时序，设备读和计数器的结果以流水线为准
+        golden_->Regs().set_value(record.dest_reg, record.value);
+    } else if (record.dest_reg != 0 && !InstructionProcessor::is_branch_type(record.type)) {
+        const uint32_t expected = golden_->Regs().get_value(record.dest_reg);
+        if (record.value != expected) {
+            report("destination register value", record, committed, expected, record.value,
+                   cycle);
+            return false;
+        }
+    }
+
+    ++checked_;
+    return true;
+}
+
+bool CosimChecker::on_interrupt(uint32_t cause, uint32_t pc, const Registers &committed,
+                                uint64_t cycle) {
+    if (failed_) {
+        return false;
+    }
+    // 中断是异步的，参考模型没有设备，只能跟随流水线响应中断的位置
+    const uint32_t expected_pc = golden_->pc();
+    if (pc != expected_pc) {
+        CommitRecord record = {};
+        record.pc = pc;
+        record.type = InstrType::HALT;
+        report("interrupt pc", record, committed, expected_pc, pc, cycle);
+        return false;
+    }
+    golden_->pc() = CSRProcessor::enter_trap(golden_->core.csr, cause, pc, 0);
+    return true;
+}
+
+bool CosimChecker::reads_timing_csr(const CommitRecord &record) const {
+    if (!InstructionProcessor::is_csr_type(record.type)) {
+        return false;
+    }
+    uint32_t raw = 0;
+    InstructionProcessor::fetch(golden_->memory, record.pc, raw);
+    return CSRProcessor::depends_on_timing(InstructionProcessor::decode(raw, record.pc).imm);
+}
+
+bool CosimChecker::finish(const CPU_State &state, uint64_t cycle) {
+    if (failed_) {
+        return false;
+    }
+    for (uint32_t i = 1; i < 32; ++i) {
+        const uint32_t expected = golden_->Regs().get_value(i);
+        const uint32_t actual = state.Regs().get_value(i);
+        if (expected != actual) {
+            CommitRecord record = {};
+            record.pc = golden_->pc();
+            record.type = InstrType::HALT;
+            record.dest_reg = i;
+            report("final register value", record, state.Regs(), expected, actual, cycle);
+            return false;
+        }
+    }
+    return true;
+}
+
+void CosimChecker::report(const char *what, const CommitRecord &record,
+                          const Registers &committed, uint64_t expected, uint64_t actual,
+                          uint64_t cycle) {
+    failed_ = true;
+
+    const uint8_t *memory = golden_->memory;
+    uint32_t raw = 0;
+    InstructionProcessor::fetch(memory, record.pc, raw);
+    Instruction instr = InstructionProcessor::decode(raw, record.pc);
+
+    cerr << "COSIM MISMATCH at cycle " << std::dec << cycle << " after " << checked_
+         << " matching commits\n"
+         << "  " << what << ": expected 0x" << std::hex << expected << ", got 0x" << actual
+         << "\n"
+         << "  pc 0x" << record.pc << ": " << InstructionProcessor::disassemble(instr) << "\n"
+         << "  reg  pipeline    reference\n";
+    for (uint32_t i = 0; i < 32; ++i) {
+        const uint32_t ours = committed.get_value(i);
+        const uint32_t theirs = golden_->Regs().get_value(i);
+        cerr << std::dec << "  x" << std::left << std::setw(3) << i << std::right << std::hex
+             << std::setfill('0') << std::setw(8) << ours << "    " << std::setw(8) << theirs
+             << std::setfill(' ') << (ours != theirs ? "  <--" : "") << "\n";
+    }
+    cerr << std::dec;
+    cerr.flush();
+}
@@ -1,32 +1,74 @@
 #include "../include/cpu_state.h"
 
-CPU_Core::CPU_Core()
+template <CoreConfig Config>
+BasicCore<Config>::BasicCore()
     : pc(0), fetch_buffer_head(0), fetch_buffer_tail(0), fetch_buffer_size(0), rob_head(0),
       rob_tail(0), rob_size(0), branch_predictor(false), fetch_stalled(false),
-      pipeline_flushed(false), clear_flag(0), commit_flag(0), next_pc(0) {
+      fetch_blocked(false), pipeline_flushed(false), clear_flag(0), commit_flag(0), next_pc(0),
+      reservation_valid(false), reservation_address(0) {
 
-    for (int i = 0; i < FETCH_BUFFER_SIZE; ++i) {
-        fetch_buffer[i] = FetchBufferEntry();
+    for (FetchBufferEntry &entry : fetch_buffer) {
+        entry = FetchBufferEntry();
     }
 
     Regs.flush();
 
-    for (int i = 0; i < ROB_SIZE; ++i) {
-        rob[i] = ROBEntry();
+    for (ROBEntry &entry : rob) {
+        entry = ROBEntry();
     }
 
-    for (int i = 0; i < RS_SIZE; ++i) {
-        rs_alu[i] = RSEntry();
+    for (RSEntry &entry : rs_alu) {
+        entry = RSEntry();
     }
-    for (int i = 0; i < RS_SIZE / 2; ++i) {
-        rs_branch[i] = RSEntry();
+    for (RSEntry &entry : rs_branch) {
+        entry = RSEntry();
     }
 
-    for (int i = 0; i < LSB_SIZE; ++i) {
-        LSB[i] = LSBEntry();
+    for (LSBEntry &entry : LSB) {
+        entry = LSBEntry();
+    }
+
+    for (InstrState &state : rob_state) {
+        state = InstrState::Dispatch;
+    }
+    for (uint32_t i = 0; i < Config.rs_size; ++i) {
+        rs_qj[i] = NO_ROB_TAG;
+        rs_qk[i] = NO_ROB_TAG;
+    }
+    for (uint32_t i = 0; i < Config.lsb_size; ++i) {
+        lsb_base_tag[i] = NO_ROB_TAG;
+        lsb_value_tag[i] = NO_ROB_TAG;
+    }
+
+    if constexpr (Config.phys_regs != 0) {
+        for (uint32_t i = 0; i < 32; ++i) {
+            prf.commit_map[i] = i;
+        }
+        restore_rename_map();
     }
 }
 
+template <CoreConfig Config> void BasicCore<Config>::restore_rename_map() {
+    if constexpr (Config.phys_regs != 0) {
+        prf.mapped = BusyBits();
+        for (uint8_t &refs : prf.refs) {
+            refs = 0;
+        }
+        for (uint32_t i = 0; i < 32; ++i) {
+            prf.rename_map[i] = prf.commit_map[i];
+            prf.mapped.set(prf.commit_map[i]);
+            ++prf.refs[prf.commit_map[i]];
+            prf.value[prf.commit_map[i]] = Regs.get_value(i);
+        }
+        prf.ready.bits = ~uint64_t(0);
+    }
+}
+
+template struct BasicCore<BASE_CORE>;
+template struct BasicCore<MEDIUM_CORE>;
+template struct BasicCore<LARGE_CORE>;
+template struct BasicCore<PRF_CORE>;
+
 CPU_State::CPU_State() {
     for (int i = 0; i < MEMORY_SIZE; i++)
         memory[i] = 0;
@@ -72,6 +114,22 @@ std::string Type_string(InstrType type) {
         return "ALU_SLTI";
     case InstrType::ALU_SLTIU:
         return "ALU_SLTIU";
+    case InstrType::MUL:
+        return "MUL";
+    case InstrType::MULH:
+        return "MULH";
+    case InstrType::MULHSU:
+        return "MULHSU";
+    case InstrType::MULHU:
+        return "MULHU";
+    case InstrType::DIV:
+        return "DIV";
+    case InstrType::DIVU:
+        return "DIVU";
+    case InstrType::REM:
+        return "REM";
+    case InstrType::REMU:
+        return "REMU";
     case InstrType::LOAD_LB:
         return "LOAD_LB";
     case InstrType::LOAD_LH:
@@ -108,6 +166,52 @@ std::string Type_string(InstrType type) {
         return "LUI";
     case InstrType::AUIPC:
         return "AUIPC";
+    case InstrType::CSRRW:
+        return "CSRRW";
+    case InstrType::CSRRS:
+        return "CSRRS";
+    case InstrType::CSRRC:
+        return "CSRRC";
+    case InstrType::CSRRWI:
+        return "CSRRWI";
+    case InstrType::CSRRSI:
+        return "CSRRSI";
+    case InstrType::CSRRCI:
+        return "CSRRCI";
+    case InstrType::LR_W:
+        return "LR_W";
+    case InstrType::SC_W:
+        return "SC_W";
+    case InstrType::AMOSWAP_W:
+        return "AMOSWAP_W";
+    case InstrType::AMOADD_W:
+        return "AMOADD_W";
+    case InstrType::AMOXOR_W:
+        return "AMOXOR_W";
+    case InstrType::AMOAND_W:
+        return "AMOAND_W";
+    case InstrType::AMOOR_W:
+        return "AMOOR_W";
+    case InstrType::AMOMIN_W:
+        return "AMOMIN_W";
+    case InstrType::AMOMAX_W:
+        return "AMOMAX_W";
+    case InstrType::AMOMINU_W:
+        return "AMOMINU_W";
+    case InstrType::AMOMAXU_W:
+        return "AMOMAXU_W";
+    case InstrType::FENCE:
+        return "FENCE";
+    case InstrType::ECALL:
+        return "ECALL";
+    case InstrType::EBREAK:
+        return "EBREAK";
+    case InstrType::MRET:
+        return "MRET";
+    case InstrType::WFI:
+        return "WFI";
+    case InstrType::ILLEGAL:
+        return "ILLEGAL";
     case InstrType::HALT:
         return "HALT";
     default:
@@ -0,0 +1,214 @@
+#include "../include/csr.h"
+
+// RV32IMAC
+static const uint32_t MISA_VALUE = (1u << 30) | (1u << ('I' - 'A')) | (1u << ('M' - 'A')) |
+                                   (1u << ('A' - 'A')) | (1u << ('C' - 'A'));
+
+// 写入64位计数器的高/低32位，通过调整偏移实现
+static void write_counter(uint64_t &offset, uint64_t now, uint32_t value, bool high) {
+    uint64_t current = now + offset;
+    if (high) {
+        current = (current & 0xFFFFFFFFull) | (static_cast<uint64_t>(value) << 32);
+    } else {
+        current = (current & ~0xFFFFFFFFull) | value;
+    }
+    offset = current - now;
+}
+
+bool CSRProcessor::read(const CSRFile &csr, const CSRCounters &counters, uint32_t address,
+                        uint32_t &value) {
+    const uint64_t cycle = counters.cycle + csr.cycle_offset;
+    const uint64_t instret = counters.instret + csr.instret_offset;
+    switch (address) {
+    case CSR_MCYCLE:
+    case CSR_CYCLE:
+    case CSR_TIME:
+        value = static_cast<uint32_t>(cycle);
+        return true;
+    case CSR_MCYCLEH:
+    case CSR_CYCLEH:
+    case CSR_TIMEH:
+        value = static_cast<uint32_t>(cycle >> 32);
+        return true;
+    case CSR_MINSTRET:
+    case CSR_INSTRET:
+        value = static_cast<uint32_t>(instret);
+        return true;
+    case CSR_MINSTRETH:
+    case CSR_INSTRETH:
+        value = static_cast<uint32_t>(instret >> 32);
+        return true;
+    case CSR_MISA:
+        value = MISA_VALUE;
+        return true;
+    case CSR_MSTATUS:
+        value = csr.mstatus | MSTATUS_MPP;
+        return true;
+    case CSR_MIE:
+        value = csr.mie;
+        return true;
+    case CSR_MTVEC:
+        value = csr.mtvec;
+        return true;
+    case CSR_MSCRATCH:
+        value = csr.mscratch;
+        return true;
+    case CSR_MEPC:
+        value = csr.mepc;
+        return true;
+    case CSR_MCAUSE:
+        value = csr.mcause;
+        return true;
+    case CSR_MTVAL:
+        value = csr.mtval;
+        return true;
+    case CSR_MIP:
+        value = csr.mip;
+        return true;
+    case CSR_MVENDORID:
+    case CSR_MARCHID:
+    case CSR_MIMPID:
+        value = 0;
+        return true;
+    case CSR_MHARTID:
+        value = csr.mhartid;
+        return true;
+    default:
+        value = 0;
+        return false;
+    }
+}
+
+bool CSRProcessor::execute(CSRFile &csr, const CSRCounters &counters, InstrType op,
+                           uint32_t address, uint32_t rs1, uint32_t operand,
+                           uint32_t &old_value) {
+    if (!read(csr, counters, address, old_value)) {
+        return false;
+    }
+
+    // CSRRS/CSRRC 在rs1为x0（或uimm为0）时只读不写
+    uint32_t value;
+    switch (op) {
+    case InstrType::CSRRW:
+    case InstrType::CSRRWI:
+        value = operand;
+        break;
+    case InstrType::CSRRS:
+    case InstrType::CSRRSI:
+        if (rs1 == 0) {
+            return true;
+        }
+        value = old_value | operand;
+        break;
+    case InstrType::CSRRC:
+    case InstrType::CSRRCI:
+        if (rs1 == 0) {
+            return true;
+        }
+        value = old_value & ~operand;
+        break;
+    default:
+        return true;
+    }
+
+    switch (address) {
+    case CSR_MSTATUS:
+        csr.mstatus = value & (MSTATUS_MIE | MSTATUS_MPIE);
+        break;
+    case CSR_MIE:
+        csr.mie = value & (MIP_MSIP | MIP_MTIP | MIP_MEIP);
+        break;
+    case CSR_MTVEC:
+        // 只支持direct(0)与vectored(1)两种模式
+        csr.mtvec = (value & 0x3) <= 1 ? value : value & ~0x3u;
+        break;
+    case CSR_MSCRATCH:
+        csr.mscratch = value;
+        break;
+    case CSR_MEPC:
+        csr.mepc = value & ~1u;
+        break;
+    case CSR_MCAUSE:
+        csr.mcause = value;
+        break;
+    case CSR_MTVAL:
+        csr.mtval = value;
+        break;
+    case CSR_MCYCLE:
+    case CSR_MCYCLEH:
+        write_counter(csr.cycle_offset, counters.cycle, value, address == CSR_MCYCLEH);
+        break;
+    case CSR_MINSTRET:
+    case CSR_MINSTRETH:
+        // 当前这条指令提交后minstret还会加一，写入的值应是其之后的值
+        write_counter(csr.instret_offset, counters.instret + 1, value,
+                      address == CSR_MINSTRETH);
+        break;
+    case CSR_MISA:
+        break; // WARL，不支持修改扩展
+    case CSR_MIP:
+        break; // 机器模式的中断位由设备驱动
+    default:
+        return false; // 地址高两位为11的CSR只读
+    }
+    return true;
+}
+
+uint32_t CSRProcessor::enter_trap(CSRFile &csr, uint32_t cause, uint32_t pc, uint32_t tval) {
+    csr.mepc = pc;
+    csr.mcause = cause;
+    csr.mtval = tval;
+    csr.mstatus = (csr.mstatus & MSTATUS_MIE) ? (csr.mstatus | MSTATUS_MPIE) & ~MSTATUS_MIE
+                                              : csr.mstatus & ~MSTATUS_MPIE;
+    // 同步异常总是进入基地址，vectored模式下中断进入 base + 4*cause
+    const uint32_t base = csr.mtvec & ~0x3u;
+    if ((csr.mtvec & 0x3) == 1 && (cause & MCAUSE_INTERRUPT)) {
+        return base + 4 * (cause & ~MCAUSE_INTERRUPT);
+    }
+    return base;
+}
+
+uint32_t CSRProcessor::return_from_trap(CSRFile &csr) {
+    csr.mstatus = (csr.mstatus & MSTATUS_MPIE) ? csr.mstatus | MSTATUS_MIE | MSTATUS_MPIE
+                                               : (csr.mstatus & ~MSTATUS_MIE) | MSTATUS_MPIE;
+    return csr.mepc;
+}
+
+uint32_t CSRProcessor::pending_interrupt(const CSRFile &csr) {
+    const uint32_t pending = csr.mip & csr.mie;
+    if (!(csr.mstatus & MSTATUS_MIE) || !pending) {
+        return 0;
+    }
+    // 优先级：外部 > 软件 > 定时器
+    if (pending & MIP_MEIP) {
+        return MCAUSE_INTERRUPT | 11;
+    }
+    if (pending & MIP_MSIP) {
+        return MCAUSE_INTERRUPT | 3;
+    }
+    return MCAUSE_INTERRUPT | 7;
+}
+
+bool CSRProcessor::depends_on_timing(uint32_t address) {
+    switch (address) {
+    case CSR_MIP:
+    case CSR_MCYCLE:
+    case CSR_MCYCLEH:
+    case CSR_MINSTRET:
+    case CSR_MINSTRETH:
+    case CSR_CYCLE:
+    case CSR_CYCLEH:
+    case CSR_TIME:
+    case CSR_TIMEH:
+    case CSR_INSTRET:
+    case CSR_INSTRETH:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void CSRProcessor::rebase(CSRFile &csr, const CSRCounters &from, const CSRCounters &to) {
+    csr.cycle_offset += from.cycle - to.cycle;
+    csr.instret_offset += from.instret - to.instret;
+}
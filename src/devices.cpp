@@ -0,0 +1,108 @@
+#include "../include/devices.h"
+
+#include "../include/csr.h"
+
+#include <utility>
+
+// 读出64位寄存器中从byte开始的size字节
+static uint32_t read_bytes(uint64_t reg, uint32_t byte, uint32_t size) {
+    const uint64_t value = reg >> (byte * 8);
+    return size >= 4 ? static_cast<uint32_t>(value)
+                     : static_cast<uint32_t>(value & ((1u << (size * 8)) - 1));
+}
+
+// 写入64位寄存器中从byte开始的size字节
+static void write_bytes(uint64_t &reg, uint32_t byte, uint32_t size, uint32_t value) {
+    for (uint32_t i = 0; i < size && byte + i < 8; ++i) {
+        const uint32_t shift = (byte + i) * 8;
+        reg = (reg & ~(0xFFull << shift)) | (static_cast<uint64_t>((value >> (i * 8)) & 0xFF)
+                                             << shift);
+    }
+}
+
+uint32_t Uart::read(uint32_t offset, uint32_t size) {
+    switch (offset) {
+    case REG_DATA: {
+        char c;
+        return console_.read_console(c) ? static_cast<uint8_t>(c) : 0;
+    }
+    case REG_LSR:
+        return LSR_THR_EMPTY | LSR_TX_IDLE | (console_.console_ready() ? LSR_DATA_READY : 0);
+    default:
+        return 0;
+    }
+}
+
+void Uart::write(uint32_t offset, uint32_t size, uint32_t value) {
+    if (offset == REG_DATA) {
+        char c = static_cast<char>(value);
+        console_.write_console(1, &c, 1);
+    }
+}
+
+Clint::Clint(Bus &bus, EventQueue &events, std::function<uint64_t()> clock)
+    : bus_(bus), events_(events), clock_(std::move(clock)) {
+    for (uint32_t i = 0; i < MAX_HARTS; ++i) {
+        timer_scheduled_[i] = false;
+    }
+}
+
+uint32_t Clint::read(uint32_t offset, uint32_t size) {
+    if (offset < REG_MSIP + 4 * MAX_HARTS) {
+        return read_bytes(regs_.msip[offset / 4], offset % 4, size);
+    }
+    if (offset >= REG_MTIMECMP && offset < REG_MTIMECMP + 8 * MAX_HARTS) {
+        const uint32_t relative = offset - REG_MTIMECMP;
+        return read_bytes(regs_.mtimecmp[relative / 8], relative % 8, size);
+    }
+    if (offset >= REG_MTIME && offset < REG_MTIME + 8) {
+        return read_bytes(clock_(), offset - REG_MTIME, size);
+    }
+    return 0;
+}
+
+void Clint::write(uint32_t offset, uint32_t size, uint32_t value) {
+    if (offset < REG_MSIP + 4 * MAX_HARTS && offset % 4 == 0) {
+        const uint32_t hart = offset / 4;
+        regs_.msip[hart] = value & 1;
+        bus_.set_interrupt(hart, MIP_MSIP, regs_.msip[hart] != 0);
+    } else if (offset >= REG_MTIMECMP && offset < REG_MTIMECMP + 8 * MAX_HARTS) {
+        const uint32_t relative = offset - REG_MTIMECMP;
+        write_bytes(regs_.mtimecmp[relative / 8], relative % 8, size, value);
+        update_timer(relative / 8);
+    }
+}
+
+void Clint::set_state(const ClintState &state) {
+    regs_ = state;
+    for (uint32_t hart = 0; hart < MAX_HARTS; ++hart) {
+        bus_.set_interrupt(hart, MIP_MSIP, regs_.msip[hart] != 0);
+        update_timer(hart);
+    }
+}
+
+void Clint::update_timer(uint32_t hart) {
+    if (timer_scheduled_[hart]) {
+        events_.cancel(timer_event_[hart]);
+        timer_scheduled_[hart] = false;
+    }
+    if (regs_.mtimecmp[hart] <= clock_()) {
+        bus_.set_interrupt(hart, MIP_MTIP, true);
+        return;
+    }
+    bus_.set_interrupt(hart, MIP_MTIP, false);
+    if (regs_.mtimecmp[hart] == UINT64_MAX) {
+        return;
+    }
+    timer_event_[hart] = events_.schedule(regs_.mtimecmp[hart], [this, hart]() {
+        timer_scheduled_[hart] = false;
+        bus_.set_interrupt(hart, MIP_MTIP, true);
+    });
+    timer_scheduled_[hart] = true;
+}
+
+void ToHost::write(uint32_t offset, uint32_t size, uint32_t value) {
+    if (offset == 0 && (value & 1)) {
+        bus_.request_exit(value >> 1);
+    }
+}
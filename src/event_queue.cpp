@@ -0,0 +1,17 @@
+#include "../include/event_queue.h"
+
+#include <utility>
+
+EventQueue::EventId EventQueue::schedule(uint64_t cycle, Action action) {
+    const EventId id(cycle, next_seq_++);
+    events_.emplace(id, std::move(action));
+    return id;
+}
+
+void EventQueue::run_until(uint64_t now) {
+    while (!events_.empty() && events_.begin()->first.first <= now) {
+        Action action = std::move(events_.begin()->second);
+        events_.erase(events_.begin());
+        action();
+    }
+}
@@ -0,0 +1,208 @@
+#include "../include/functional_core.h"
+
+#include "../include/csr.h"
+#include "../include/memory_access.h"
+
+FunctionalCore::FunctionalCore()
+    : bbv_(nullptr), syscalls_(nullptr), bus_(nullptr), address_map_(nullptr), halted_(false),
+      instruction_count_(0),
+      last_device_access_(false), misaligned_policy_(MisalignedPolicy::Emulate) {
+    last_store_.valid = false;
+    last_store_.address = 0;
+    last_store_.value = 0;
+}
+
+bool FunctionalCore::step(CPU_State &cpu) {
+    if (halted_) {
+        return false;
+    }
+
+    last_store_.valid = false;
+    last_device_access_ = false;
+
+    // 在指令边界检查中断；没有挂接总线（如差分检查的参考模型）时中断由外部注入
+    if (bus_) {
+        cpu.core.csr.mip = bus_->get_pending_interrupts(cpu.core.csr.mhartid);
+    }
+    const uint32_t interrupt = CSRProcessor::pending_interrupt(cpu.core.csr);
+    if (interrupt) {
+        cpu.pc() = CSRProcessor::enter_trap(cpu.core.csr, interrupt, cpu.pc(), 0);
+        return true;
+    }
+
+    const uint32_t pc = cpu.pc();
+    const uint8_t *memory = cpu.memory;
+    uint32_t raw;
+    if (!InstructionProcessor::fetch(memory, pc, raw)) {
+        return raise_exception(cpu, ExceptionCause::InstructionAccessFault, pc, pc);
+    }
+
+    Instruction instr = InstructionProcessor::decode(raw, pc);
+    if (instr.type == InstrType::HALT) {
+        halted_ = true;
+        return false;
+    }
+    if (instr.type == InstrType::ILLEGAL) {
+        return raise_exception(cpu, ExceptionCause::IllegalInstruction, pc, instr.raw);
+    }
+    if (instr.type == InstrType::EBREAK) {
+        return raise_exception(cpu, ExceptionCause::Breakpoint, pc, pc);
+    }
+    if (instr.type == InstrType::ECALL && CSRProcessor::traps_enabled(cpu.core.csr)) {
+        return raise_exception(cpu, ExceptionCause::EnvironmentCallFromM, pc, 0);
+    }
+
+    Registers &regs = cpu.Regs();
+    uint32_t val1 = regs.get_value(instr.rs1);
+    uint32_t val2 = regs.get_value(instr.rs2);
+    uint32_t next_pc = pc + instr.length;
+
+    if (InstructionProcessor::is_alu_type(instr.type) ||
+        InstructionProcessor::is_muldiv_type(instr.type)) {
+        regs.set_value(instr.rd, InstructionProcessor::execute_alu(instr.type, val1, val2,
+                                                                   instr.imm));
+    } else if (InstructionProcessor::is_branch_type(instr.type)) {
+        if (InstructionProcessor::check_branch_condition(instr.type, val1, val2)) {
+            next_pc = pc + instr.imm;
+        }
+    } else if (InstructionProcessor::is_load_type(instr.type)) {
+        uint32_t address = val1 + instr.imm;
+        uint32_t size = InstructionProcessor::get_access_size(instr.type);
+        uint32_t value = 0;
+        if (misaligned_policy_ == MisalignedPolicy::Trap &&
+            !MemoryAccess::is_aligned(address, size)) {
+            return raise_exception(cpu, ExceptionCause::LoadAddressMisaligned, pc, address);
+        }
+        if (!Bus::is_ram(address, size) && !is_mapped(address, size)) {
+            return raise_exception(cpu, ExceptionCause::LoadAccessFault, pc, address);
+        }
+        if (Bus::is_ram(address, size)) {
+            value = InstructionProcessor::extend_load(instr.type,
+                                                      MemoryAccess::read(memory, address, size));
+        } else {
+            last_device_access_ = true;
+            if (bus_) {
+                bus_->read(address, size, value);
+                value = InstructionProcessor::extend_load(instr.type, value);
+            }
+        }
+        regs.set_value(instr.rd, value);
+    } else if (InstructionProcessor::is_store_type(instr.type)) {
+        uint32_t address = val1 + instr.imm;
+        uint32_t size = InstructionProcessor::get_access_size(instr.type);
+        if (misaligned_policy_ == MisalignedPolicy::Trap &&
+            !MemoryAccess::is_aligned(address, size)) {
+            return raise_exception(cpu, ExceptionCause::StoreAddressMisaligned, pc, address);
+        }
+        if (!Bus::is_ram(address, size) && !is_mapped(address, size)) {
+            return raise_exception(cpu, ExceptionCause::StoreAccessFault, pc, address);
+        }
+        last_store_.valid = true;
+        last_store_.address = address;
+        last_store_.value = val2;
+        if (Bus::is_ram(address, size)) {
+            MemoryAccess::write(cpu.memory, address, size, val2);
+        } else {
+            last_device_access_ = true;
+            if (bus_) {
+                bus_->write(address, size, val2);
+                halted_ = bus_->has_exited();
+            }
+        }
+    } else if (instr.type == InstrType::JUMP_JAL) {
+        regs.set_value(instr.rd, pc + instr.length);
+        next_pc = pc + instr.imm;
+    } else if (instr.type == InstrType::JUMP_JALR) {
+        next_pc = (val1 + instr.imm) & ~1u;
+        regs.set_value(instr.rd, pc + instr.length);
+    } else if (instr.type == InstrType::LUI) {
+        regs.set_value(instr.rd, instr.imm);
+    } else if (instr.type == InstrType::AUIPC) {
+        regs.set_value(instr.rd, pc + instr.imm);
+    } else if (InstructionProcessor::is_csr_type(instr.type)) {
+        // 功能模型没有时序，cycle按每条指令一个周期计
+        const bool immediate = instr.type >= InstrType::CSRRWI;
+        CSRCounters counters;
+        counters.cycle = instruction_count_;
+        counters.instret = instruction_count_;
+        uint32_t old_value;
+        if (!CSRProcessor::execute(cpu.core.csr, counters, instr.type, instr.imm, instr.rs1,
+                                   immediate ? instr.rs1 : val1, old_value)) {
+            return raise_exception(cpu, ExceptionCause::IllegalInstruction, pc, instr.raw);
+        }
+        regs.set_value(instr.rd, old_value);
+    } else if (InstructionProcessor::is_atomic_type(instr.type)) {
+        const bool is_lr = instr.type == InstrType::LR_W;
+        if (!MemoryAccess::is_aligned(val1, 4)) {
+            return raise_exception(cpu,
+                                   is_lr ? ExceptionCause::LoadAddressMisaligned
+                                         : ExceptionCause::StoreAddressMisaligned,
+                                   pc, val1);
+        }
+        if (!Bus::is_ram(val1, 4)) {
+            return raise_exception(cpu,
+                                   is_lr ? ExceptionCause::LoadAccessFault
+                                         : ExceptionCause::StoreAccessFault,
+                                   pc, val1);
+        }
+        uint32_t result;
+        if (is_lr) {
+            result = MemoryAccess::read(memory, val1, 4);
+            cpu.core.reservation_valid = true;
+            cpu.core.reservation_address = val1;
+        } else if (instr.type == InstrType::SC_W) {
+            const bool reserved =
+                cpu.core.reservation_valid && cpu.core.reservation_address == val1;
+            cpu.core.reservation_valid = false;
+            result = reserved ? 0 : 1;
+            if (reserved) {
+                MemoryAccess::write(cpu.memory, val1, 4, val2);
+                last_store_ = {true, val1, val2};
+            }
+        } else {
+            result = MemoryAccess::read(memory, val1, 4);
+            const uint32_t value = InstructionProcessor::execute_amo(instr.type, result, val2);
+            MemoryAccess::write(cpu.memory, val1, 4, value);
+            last_store_ = {true, val1, value};
+        }
+        regs.set_value(instr.rd, result);
+    } else if (instr.type == InstrType::WFI) {
+        // 功能模型没有时间的概念，WFI按NOP执行
+    } else if (instr.type == InstrType::MRET) {
+        next_pc = CSRProcessor::return_from_trap(cpu.core.csr);
+    } else if (instr.type == InstrType::ECALL) {
+        if (syscalls_) {
+            syscalls_->handle(regs, cpu.memory);
+            halted_ = syscalls_->has_exited();
+        }
+    }
+
+    if (bbv_) {
+        bbv_->on_instruction(pc, instr.type);
+    }
+
+    cpu.pc() = next_pc;
+    ++instruction_count_;
+    return true;
+}
+
+uint64_t FunctionalCore::run(CPU_State &cpu, uint64_t max_instructions) {
+    uint64_t executed = 0;
+    while (executed < max_instructions && step(cpu)) {
+        ++executed;
+    }
+    return executed;
+}
+
+bool FunctionalCore::raise_exception(CPU_State &cpu, ExceptionCause cause, uint32_t pc,
+                                     uint32_t tval) {
+    if (CSRProcessor::traps_enabled(cpu.core.csr)) {
+        cpu.pc() = CSRProcessor::enter_trap(cpu.core.csr, static_cast<uint32_t>(cause), pc, tval);
+        return true;
+    }
+    exception_.cause = cause;
+    exception_.pc = pc;
+    exception_.tval = tval;
+    halted_ = true;
+    return false;
+}
@@ -1,19 +1,225 @@
 #include "../include/instruction.h"
 
+#include "../include/memory_access.h"
+
+#include <sstream>
+
+bool InstructionProcessor::fetch(const uint8_t memory[], uint32_t pc, uint32_t &raw) {
+    if (pc > MEMORY_SIZE - 2) {
+        return false;
+    }
+    raw = MemoryAccess::read(memory, pc, 2);
+    if (is_compressed(raw)) {
+        return true;
+    }
+    // 32位指令可能只按2字节对齐
+    if (pc > MEMORY_SIZE - 4) {
+        return false;
+    }
+    raw |= MemoryAccess::read(memory, pc + 2, 2) << 16;
+    return true;
+}
+
 Instruction InstructionProcessor::decode(uint32_t raw_instruction, uint32_t pc) {
     Instruction instr;
     instr.raw = raw_instruction;
     instr.pc = pc;
-    instr.rd = (raw_instruction >> 7) & 0x1F;
-    instr.rs1 = (raw_instruction >> 15) & 0x1F;
-    instr.rs2 = (raw_instruction >> 20) & 0x1F;
 
-    instr.type = decode_opcode(raw_instruction);
-    instr.imm = extract_immediate(raw_instruction, instr.type);
+    uint32_t expanded = raw_instruction;
+    if (is_compressed(raw_instruction)) {
+        instr.raw = raw_instruction & 0xFFFF;
+        instr.length = 2;
+        expanded = expand_compressed(instr.raw);
+    }
+
+    instr.rd = (expanded >> 7) & 0x1F;
+    instr.rs1 = (expanded >> 15) & 0x1F;
+    instr.rs2 = (expanded >> 20) & 0x1F;
+
+    instr.type = decode_opcode(expanded);
+    instr.imm = extract_immediate(expanded, instr.type);
 
     return instr;
 }
 
+// 32位指令编码辅助函数
+static uint32_t encode_r(uint32_t funct7, uint32_t rs2, uint32_t rs1, uint32_t funct3,
+                         uint32_t rd, uint32_t opcode) {
+    return (funct7 << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode;
+}
+
+static uint32_t encode_i(int32_t imm, uint32_t rs1, uint32_t funct3, uint32_t rd,
+                         uint32_t opcode) {
+    return ((static_cast<uint32_t>(imm) & 0xFFF) << 20) | (rs1 << 15) | (funct3 << 12) |
+           (rd << 7) | opcode;
+}
+
+static uint32_t encode_s(int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t funct3) {
+    uint32_t u = static_cast<uint32_t>(imm);
+    return (((u >> 5) & 0x7F) << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) |
+           ((u & 0x1F) << 7) | 0x23;
+}
+
+static uint32_t encode_b(int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t funct3) {
+    uint32_t u = static_cast<uint32_t>(imm);
+    return (((u >> 12) & 1) << 31) | (((u >> 5) & 0x3F) << 25) | (rs2 << 20) | (rs1 << 15) |
+           (funct3 << 12) | (((u >> 1) & 0xF) << 8) | (((u >> 11) & 1) << 7) | 0x63;
+}
+
+static uint32_t encode_j(int32_t imm, uint32_t rd) {
+    uint32_t u = static_cast<uint32_t>(imm);
+    return (((u >> 20) & 1) << 31) | (((u >> 1) & 0x3FF) << 21) | (((u >> 11) & 1) << 20) |
+           (((u >> 12) & 0xFF) << 12) | (rd << 7) | 0x6F;
+}
+
+// 取出第hi..lo位
+static uint32_t bits(uint32_t value, int hi, int lo) {
+    return (value >> lo) & ((1u << (hi - lo + 1)) - 1);
+}
+
+// 将width位的值做符号扩展
+static int32_t sign_extend(uint32_t value, int width) {
+    return static_cast<int32_t>(value << (32 - width)) >> (32 - width);
+}
+
+uint32_t InstructionProcessor::expand_compressed(uint16_t c) {
+    const uint32_t op = c & 0x3;
+    const uint32_t funct3 = bits(c, 15, 13);
+    const uint32_t rd = bits(c, 11, 7);    // 完整寄存器号 rd/rs1
+    const uint32_t rs2 = bits(c, 6, 2);    // 完整寄存器号 rs2
+    const uint32_t rd_p = bits(c, 4, 2) + 8;  // rd'/rs2'
+    const uint32_t rs1_p = bits(c, 9, 7) + 8; // rs1'/rd'
+
+    if (c == 0) {
+        return 0;
+    }
+
+    switch (op) {
+    case 0x0:
+        switch (funct3) {
+        case 0x0: { // C.ADDI4SPN
+            uint32_t imm = (bits(c, 12, 11) << 4) | (bits(c, 10, 7) << 6) | (bits(c, 6, 6) << 2) |
+                           (bits(c, 5, 5) << 3);
+            if (imm == 0) {
+                return 0;
+            }
+            return encode_i(imm, 2, 0x0, rd_p, 0x13);
+        }
+        case 0x2: { // C.LW
+            uint32_t imm = (bits(c, 12, 10) << 3) | (bits(c, 6, 6) << 2) | (bits(c, 5, 5) << 6);
+            return encode_i(imm, rs1_p, 0x2, rd_p, 0x03);
+        }
+        case 0x6: { // C.SW
+            uint32_t imm = (bits(c, 12, 10) << 3) | (bits(c, 6, 6) << 2) | (bits(c, 5, 5) << 6);
+            return encode_s(imm, rd_p, rs1_p, 0x2);
+        }
+        }
+        return 0;
+
+    case 0x1: {
+        const int32_t imm6 = sign_extend((bits(c, 12, 12) << 5) | bits(c, 6, 2), 6);
+        // C.JAL/C.J 的跳转偏移
+        const int32_t jimm = sign_extend((bits(c, 12, 12) << 11) | (bits(c, 11, 11) << 4) |
+                                             (bits(c, 10, 9) << 8) | (bits(c, 8, 8) << 10) |
+                                             (bits(c, 7, 7) << 6) | (bits(c, 6, 6) << 7) |
+                                             (bits(c, 5, 3) << 1) | (bits(c, 2, 2) << 5),
+                                         12);
+        // C.BEQZ/C.BNEZ 的分支偏移
+        const int32_t bimm = sign_extend((bits(c, 12, 12) << 8) | (bits(c, 11, 10) << 3) |
+                                             (bits(c, 6, 5) << 6) | (bits(c, 4, 3) << 1) |
+                                             (bits(c, 2, 2) << 5),
+                                         9);
+        switch (funct3) {
+        case 0x0: // C.ADDI / C.NOP
+            return encode_i(imm6, rd, 0x0, rd, 0x13);
+        case 0x1: // C.JAL
+            return encode_j(jimm, 1);
+        case 0x2: // C.LI
+            return encode_i(imm6, 0, 0x0, rd, 0x13);
+        case 0x3:
+            if (rd == 2) { // C.ADDI16SP
+                int32_t imm = sign_extend((bits(c, 12, 12) << 9) | (bits(c, 6, 6) << 4) |
+                                              (bits(c, 5, 5) << 6) | (bits(c, 4, 3) << 7) |
+                                              (bits(c, 2, 2) << 5),
+                                          10);
+                if (imm == 0) {
+                    return 0;
+                }
+                return encode_i(imm, 2, 0x0, 2, 0x13);
+            }
+            // C.LUI
+            if (imm6 == 0 || rd == 0) {
+                return 0;
+            }
+            return (static_cast<uint32_t>(imm6) << 12) | (rd << 7) | 0x37;
+        case 0x4: {
+            const uint32_t shamt = bits(c, 6, 2);
+            switch (bits(c, 11, 10)) {
+            case 0x0: // C.SRLI
+                return bits(c, 12, 12) ? 0 : encode_r(0x00, shamt, rs1_p, 0x5, rs1_p, 0x13);
+            case 0x1: // C.SRAI
+                return bits(c, 12, 12) ? 0 : encode_r(0x20, shamt, rs1_p, 0x5, rs1_p, 0x13);
+            case 0x2: // C.ANDI
+                return encode_i(imm6, rs1_p, 0x7, rs1_p, 0x13);
+            case 0x3:
+                if (bits(c, 12, 12)) {
+                    return 0; // RV64 的 C.SUBW/C.ADDW
+                }
+                switch (bits(c, 6, 5)) {
+                case 0x0: // C.SUB
+                    return encode_r(0x20, rd_p, rs1_p, 0x0, rs1_p, 0x33);
+                case 0x1: // C.XOR
+                    return encode_r(0x00, rd_p, rs1_p, 0x4, rs1_p, 0x33);
+                case 0x2: // C.OR
+                    return encode_r(0x00, rd_p, rs1_p, 0x6, rs1_p, 0x33);
+                case 0x3: // C.AND
+                    return encode_r(0x00, rd_p, rs1_p, 0x7, rs1_p, 0x33);
+                }
+            }
+            return 0;
+        }
+        case 0x5: // C.J
+            return encode_j(jimm, 0);
+        case 0x6: // C.BEQZ
+            return encode_b(bimm, 0, rs1_p, 0x0);
+        case 0x7: // C.BNEZ
+            return encode_b(bimm, 0, rs1_p, 0x1);
+        }
+        return 0;
+    }
+
+    case 0x2:
+        switch (funct3) {
+        case 0x0: // C.SLLI
+            return bits(c, 12, 12) ? 0 : encode_r(0x00, rs2, rd, 0x1, rd, 0x13);
+        case 0x2: { // C.LWSP
+            uint32_t imm = (bits(c, 12, 12) << 5) | (bits(c, 6, 4) << 2) | (bits(c, 3, 2) << 6);
+            return rd == 0 ? 0 : encode_i(imm, 2, 0x2, rd, 0x03);
+        }
+        case 0x4:
+            if (bits(c, 12, 12) == 0) {
+                if (rs2 == 0) { // C.JR
+                    return rd == 0 ? 0 : encode_i(0, rd, 0x0, 0, 0x67);
+                }
+                return encode_r(0x00, rs2, 0, 0x0, rd, 0x33); // C.MV
+            }
+            if (rs2 == 0) {
+                if (rd == 0) {
+                    return 0x00100073; // C.EBREAK
+                }
+                return encode_i(0, rd, 0x0, 1, 0x67); // C.JALR
+            }
+            return encode_r(0x00, rs2, rd, 0x0, rd, 0x33); // C.ADD
+        case 0x6: { // C.SWSP
+            uint32_t imm = (bits(c, 12, 9) << 2) | (bits(c, 8, 7) << 6);
+            return encode_s(imm, rs2, 2, 0x2);
+        }
+        }
+        return 0;
+    }
+    return 0;
+}
+
 InstrType InstructionProcessor::decode_opcode(uint32_t instruction) {
     uint32_t opcode = instruction & 0x7F;
     uint32_t funct3 = (instruction >> 12) & 0x7;
@@ -51,6 +257,25 @@ InstrType InstructionProcessor::decode_opcode(uint32_t instruction) {
             case 0x5:
                 return InstrType::ALU_SRA;
             }
+        } else if (funct7 == 0x01) { // RV32M
+            switch (funct3) {
+            case 0x0:
+                return InstrType::MUL;
+            case 0x1:
+                return InstrType::MULH;
+            case 0x2:
+                return InstrType::MULHSU;
+            case 0x3:
+                return InstrType::MULHU;
+            case 0x4:
+                return InstrType::DIV;
+            case 0x5:
+                return InstrType::DIVU;
+            case 0x6:
+                return InstrType::REM;
+            case 0x7:
+                return InstrType::REMU;
+            }
         }
         break;
 
@@ -69,9 +294,17 @@ InstrType InstructionProcessor::decode_opcode(uint32_t instruction) {
         case 0x7:
             return InstrType::ALU_ANDI;
         case 0x1:
-            return InstrType::ALU_SLLI;
+            if (funct7 == 0x00) {
+                return InstrType::ALU_SLLI;
+            }
+            break;
         case 0x5:
-            return (funct7 == 0x00) ? InstrType::ALU_SRLI : InstrType::ALU_SRAI;
+            if (funct7 == 0x00) {
+                return InstrType::ALU_SRLI;
+            } else if (funct7 == 0x20) {
+                return InstrType::ALU_SRAI;
+            }
+            break;
         }
         break;
 
@@ -125,10 +358,76 @@ InstrType InstructionProcessor::decode_opcode(uint32_t instruction) {
     case 0x6F:
         return InstrType::JUMP_JAL;
     case 0x67:
-        return InstrType::JUMP_JALR;
+        if (funct3 == 0x0) {
+            return InstrType::JUMP_JALR;
+        }
+        break;
+    case 0x2F: // AMO
+        if (funct3 == 0x2) {
+            switch (instruction >> 27) {
+            case 0x02:
+                if (((instruction >> 20) & 0x1F) == 0) {
+                    return InstrType::LR_W;
+                }
+                break;
+            case 0x03:
+                return InstrType::SC_W;
+            case 0x01:
+                return InstrType::AMOSWAP_W;
+            case 0x00:
+                return InstrType::AMOADD_W;
+            case 0x04:
+                return InstrType::AMOXOR_W;
+            case 0x0C:
+                return InstrType::AMOAND_W;
+            case 0x08:
+                return InstrType::AMOOR_W;
+            case 0x10:
+                return InstrType::AMOMIN_W;
+            case 0x14:
+                return InstrType::AMOMAX_W;
+            case 0x18:
+                return InstrType::AMOMINU_W;
+            case 0x1C:
+                return InstrType::AMOMAXU_W;
+            }
+        }
+        break;
+    case 0x0F: // MISC-MEM
+        if (funct3 == 0x0 || funct3 == 0x1) {
+            return InstrType::FENCE;
+        }
+        break;
+    case 0x73: // SYSTEM
+        switch (funct3) {
+        case 0x0:
+            if (instruction == 0x00000073) {
+                return InstrType::ECALL;
+            } else if (instruction == 0x00100073) {
+                return InstrType::EBREAK;
+            } else if (instruction == 0x30200073) {
+                return InstrType::MRET;
+            } else if (instruction == 0x10500073) {
+                return InstrType::WFI;
+            }
+            break;
+        case 0x1:
+            return InstrType::CSRRW;
+        case 0x2:
+            return InstrType::CSRRS;
+        case 0x3:
+            return InstrType::CSRRC;
+        case 0x5:
+            return InstrType::CSRRWI;
+        case 0x6:
+            return InstrType::CSRRSI;
+        case 0x7:
+            return InstrType::CSRRCI;
+        }
+        break;
     }
 
-    return InstrType::HALT; 
+    return InstrType::ILLEGAL;
 }
 
 int32_t InstructionProcessor::extract_immediate(uint32_t instruction, InstrType type) {
@@ -157,6 +456,9 @@ int32_t InstructionProcessor::extract_immediate(uint32_t instruction, InstrType
     case 0x17: // AUIPC (U-type)
         return instruction & 0xFFFFF000;
 
+    case 0x73: // CSR地址，无符号
+        return instruction >> 20;
+
     case 0x6F: // JAL (J-type)
     {
         uint32_t imm_20 = (instruction >> 31) & 1;
@@ -179,6 +481,18 @@ bool InstructionProcessor::is_branch_type(InstrType type) {
     return type >= InstrType::BRANCH_BEQ && type <= InstrType::BRANCH_BGEU;
 }
 
+bool InstructionProcessor::is_mul_type(InstrType type) {
+    return type >= InstrType::MUL && type <= InstrType::MULHU;
+}
+
+bool InstructionProcessor::is_div_type(InstrType type) {
+    return type >= InstrType::DIV && type <= InstrType::REMU;
+}
+
+bool InstructionProcessor::is_muldiv_type(InstrType type) {
+    return type >= InstrType::MUL && type <= InstrType::REMU;
+}
+
 bool InstructionProcessor::is_load_type(InstrType type) {
     return type >= InstrType::LOAD_LB && type <= InstrType::LOAD_LHU;
 }
@@ -187,6 +501,144 @@ bool InstructionProcessor::is_store_type(InstrType type) {
     return type >= InstrType::STORE_SB && type <= InstrType::STORE_SW;
 }
 
+bool InstructionProcessor::is_csr_type(InstrType type) {
+    return type >= InstrType::CSRRW && type <= InstrType::CSRRCI;
+}
+
+bool InstructionProcessor::is_atomic_type(InstrType type) {
+    return type >= InstrType::LR_W && type <= InstrType::AMOMAXU_W;
+}
+
+uint32_t InstructionProcessor::execute_amo(InstrType op, uint32_t old, uint32_t operand) {
+    switch (op) {
+    case InstrType::AMOSWAP_W:
+        return operand;
+    case InstrType::AMOADD_W:
+        return old + operand;
+    case InstrType::AMOXOR_W:
+        return old ^ operand;
+    case InstrType::AMOAND_W:
+        return old & operand;
+    case InstrType::AMOOR_W:
+        return old | operand;
+    case InstrType::AMOMIN_W:
+        return static_cast<int32_t>(old) < static_cast<int32_t>(operand) ? old : operand;
+    case InstrType::AMOMAX_W:
+        return static_cast<int32_t>(old) > static_cast<int32_t>(operand) ? old : operand;
+    case InstrType::AMOMINU_W:
+        return old < operand ? old : operand;
+    case InstrType::AMOMAXU_W:
+        return old > operand ? old : operand;
+    default:
+        return old;
+    }
+}
+
+bool InstructionProcessor::is_control_flow_type(InstrType type) {
+    return is_branch_type(type) || type == InstrType::JUMP_JAL || type == InstrType::JUMP_JALR;
+}
+
+FusionKind InstructionProcessor::fuse(const Instruction &first, const Instruction &second,
+                                      Instruction &fused, uint32_t &first_value) {
+    // 第二条指令只读写第一条指令的目标寄存器，中间结果不会被其他指令看到
+    if (first.rd == 0 || second.rd != first.rd || second.rs1 != first.rd) {
+        return FusionKind::None;
+    }
+    fused = first;
+    fused.length = first.length + second.length;
+    if (first.type == InstrType::LUI && second.type == InstrType::ALU_ADDI) {
+        fused.imm = first.imm + second.imm;
+        first_value = static_cast<uint32_t>(first.imm);
+        return FusionKind::LuiAddi;
+    }
+    if (first.type == InstrType::AUIPC && second.type == InstrType::JUMP_JALR) {
+        const uint32_t target = (first.pc + first.imm + second.imm) & ~1u;
+        fused.type = InstrType::JUMP_JAL;
+        fused.imm = static_cast<int32_t>(target - first.pc);
+        first_value = first.pc + first.imm;
+        return FusionKind::AuipcJalr;
+    }
+    if (first.type == InstrType::ALU_SLLI && second.type == InstrType::ALU_SRLI &&
+        (first.imm & 0x1F) == (second.imm & 0x1F)) {
+        fused.type = InstrType::ALU_ANDI;
+        fused.imm = static_cast<int32_t>(0xFFFFFFFFu >> (first.imm & 0x1F));
+        return FusionKind::SlliSrli;
+    }
+    return FusionKind::None;
+}
+
+RenameIdiom InstructionProcessor::rename_idiom(const Instruction &instr, uint32_t &source,
+                                               uint32_t &constant) {
+    if (instr.rd == 0) {
+        return RenameIdiom::None;
+    }
+    switch (instr.type) {
+    case InstrType::ALU_ADDI:
+    case InstrType::ALU_ORI:
+    case InstrType::ALU_XORI:
+        if (instr.rs1 == 0) {
+            constant = static_cast<uint32_t>(instr.imm);
+            return RenameIdiom::Constant;
+        }
+        if (instr.imm == 0) {
+            source = instr.rs1;
+            return RenameIdiom::Move;
+        }
+        return RenameIdiom::None;
+    case InstrType::ALU_ADD:
+    case InstrType::ALU_OR:
+        if (instr.rs1 == 0 || instr.rs2 == 0) {
+            source = instr.rs1 | instr.rs2;
+            constant = 0;
+            return source ? RenameIdiom::Move : RenameIdiom::Constant;
+        }
+        return RenameIdiom::None;
+    case InstrType::ALU_XOR:
+    case InstrType::ALU_SUB:
+        if (instr.rs1 == instr.rs2) {
+            constant = 0;
+            return RenameIdiom::Constant;
+        }
+        if (instr.rs2 == 0 || (instr.type == InstrType::ALU_XOR && instr.rs1 == 0)) {
+            source = instr.rs1 | instr.rs2;
+            return RenameIdiom::Move;
+        }
+        return RenameIdiom::None;
+    default:
+        return RenameIdiom::None;
+    }
+}
+
+uint32_t InstructionProcessor::get_access_size(InstrType type) {
+    switch (type) {
+    case InstrType::LOAD_LB:
+    case InstrType::LOAD_LBU:
+    case InstrType::STORE_SB:
+        return 1;
+    case InstrType::LOAD_LH:
+    case InstrType::LOAD_LHU:
+    case InstrType::STORE_SH:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+uint32_t InstructionProcessor::extend_load(InstrType type, uint32_t data) {
+    switch (type) {
+    case InstrType::LOAD_LB:
+        return static_cast<int32_t>(static_cast<int8_t>(data));
+    case InstrType::LOAD_LBU:
+        return data & 0xFF;
+    case InstrType::LOAD_LH:
+        return static_cast<int32_t>(static_cast<int16_t>(data));
+    case InstrType::LOAD_LHU:
+        return data & 0xFFFF;
+    default:
+        return data;
+    }
+}
+
 uint32_t InstructionProcessor::execute_alu(InstrType op, uint32_t val1, uint32_t val2,
                                            int32_t imm) {
     switch (op) {
@@ -232,6 +684,41 @@ uint32_t InstructionProcessor::execute_alu(InstrType op, uint32_t val1, uint32_t
     case InstrType::ALU_SRAI:
         return static_cast<int32_t>(val1) >> (imm & 0x1F);
 
+    // RV32M，除零与溢出的结果按规范定义，不产生异常
+    case InstrType::MUL:
+        return val1 * val2;
+    case InstrType::MULH:
+        return static_cast<uint32_t>(
+            (static_cast<int64_t>(static_cast<int32_t>(val1)) *
+             static_cast<int64_t>(static_cast<int32_t>(val2))) >>
+            32);
+    case InstrType::MULHSU:
+        return static_cast<uint32_t>(
+            (static_cast<int64_t>(static_cast<int32_t>(val1)) * static_cast<int64_t>(val2)) >>
+            32);
+    case InstrType::MULHU:
+        return static_cast<uint32_t>((static_cast<uint64_t>(val1) * val2) >> 32);
+    case InstrType::DIV:
+        if (val2 == 0) {
+            return 0xFFFFFFFF;
+        }
+        if (val1 == 0x80000000 && val2 == 0xFFFFFFFF) {
+            return val1;
+        }
+        return static_cast<int32_t>(val1) / static_cast<int32_t>(val2);
+    case InstrType::DIVU:
+        return val2 == 0 ? 0xFFFFFFFF : val1 / val2;
+    case InstrType::REM:
+        if (val2 == 0) {
+            return val1;
+        }
+        if (val1 == 0x80000000 && val2 == 0xFFFFFFFF) {
+            return 0;
+        }
+        return static_cast<int32_t>(val1) % static_cast<int32_t>(val2);
+    case InstrType::REMU:
+        return val2 == 0 ? val1 : val1 % val2;
+
     // 特殊指令
     case InstrType::LUI:
         return imm;
@@ -271,5 +758,65 @@ int InstructionProcessor::get_execution_cycles(InstrType type) {
     if (is_load_type(type) || is_store_type(type)) {
         return 3; 
     }
+    if (is_mul_type(type)) {
+        return 3; // 三级流水乘法器
+    }
+    if (is_div_type(type)) {
+        return 34; // 每周期产生一位商的迭代除法器，加上预处理与结果修正
+    }
     return 1;
 }
+
+std::string InstructionProcessor::disassemble(const Instruction &instr) {
+    std::ostringstream out;
+    if (instr.length == 2) {
+        out << "c.";
+    }
+    out << Type_string(instr.type);
+
+    if (instr.type == InstrType::HALT || instr.type == InstrType::ECALL ||
+        instr.type == InstrType::EBREAK || instr.type == InstrType::MRET ||
+        instr.type == InstrType::WFI || instr.type == InstrType::FENCE) {
+        return out.str();
+    }
+    if (instr.type == InstrType::ILLEGAL) {
+        out << " 0x" << std::hex << instr.raw;
+        return out.str();
+    }
+
+    out << " ";
+    if (is_alu_type(instr.type) || is_muldiv_type(instr.type)) {
+        out << "x" << instr.rd << ", x" << instr.rs1 << ", ";
+        if ((instr.type >= InstrType::ALU_ADD && instr.type <= InstrType::ALU_SLTU) ||
+            is_muldiv_type(instr.type)) {
+            out << "x" << instr.rs2;
+        } else {
+            out << instr.imm;
+        }
+    } else if (is_load_type(instr.type)) {
+        out << "x" << instr.rd << ", " << instr.imm << "(x" << instr.rs1 << ")";
+    } else if (is_store_type(instr.type)) {
+        out << "x" << instr.rs2 << ", " << instr.imm << "(x" << instr.rs1 << ")";
+    } else if (is_branch_type(instr.type)) {
+        out << "x" << instr.rs1 << ", x" << instr.rs2 << ", 0x" << std::hex
+            << instr.pc + instr.imm;
+    } else if (instr.type == InstrType::JUMP_JAL) {
+        out << "x" << instr.rd << ", 0x" << std::hex << instr.pc + instr.imm;
+    } else if (instr.type == InstrType::JUMP_JALR) {
+        out << "x" << instr.rd << ", " << instr.imm << "(x" << instr.rs1 << ")";
+    } else if (instr.type == InstrType::LR_W) {
+        out << "x" << instr.rd << ", (x" << instr.rs1 << ")";
+    } else if (is_atomic_type(instr.type)) {
+        out << "x" << instr.rd << ", x" << instr.rs2 << ", (x" << instr.rs1 << ")";
+    } else if (is_csr_type(instr.type)) {
+        out << "x" << instr.rd << ", 0x" << std::hex << instr.imm << std::dec << ", ";
+        if (instr.type >= InstrType::CSRRWI) {
+            out << instr.rs1;
+        } else {
+            out << "x" << instr.rs1;
+        }
+    } else if (instr.type == InstrType::LUI || instr.type == InstrType::AUIPC) {
+        out << "x" << instr.rd << ", 0x" << std::hex << (static_cast<uint32_t>(instr.imm) >> 12);
+    }
+    return out.str();
+}
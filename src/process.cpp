@@ -1,34 +1,133 @@
 #include "../include/process.h"
 
 #include "../include/cpu_state.h"
+#include "../include/csr.h"
+#include "../include/memory_access.h"
 
+#include <bit>
 #include <iostream>
 #include <ostream>
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
 int CNT = 0;
 
-CPU::CPU() : cycle_count_(0), instruction_count_(0), branch_mispredictions_(0) {}
+// tags[0..N)中等于keys任一元素的条目组成的位图，第i位对应tags[i]；
+// 每次比较16（SSE2）或32（AVX2）个标签，余下的条目逐个比较
+template <uint32_t N>
+static uint64_t match_tags(const RobTag tags[], const RobTag keys[], uint32_t key_count) {
+    uint64_t match = 0;
+    uint32_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= N; i += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tags + i));
+        __m256i eq = _mm256_setzero_si256();
+        for (uint32_t k = 0; k < key_count; ++k) {
+            eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(keys[k])));
+        }
+        match |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(eq))) << i;
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= N; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tags + i));
+        __m128i eq = _mm_setzero_si128();
+        for (uint32_t k = 0; k < key_count; ++k) {
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(keys[k])));
+        }
+        match |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(eq))) << i;
+    }
+#endif
+    for (; i < N; ++i) {
+        for (uint32_t k = 0; k < key_count; ++k) {
+            match |= static_cast<uint64_t>(tags[i] == keys[k]) << i;
+        }
+    }
+    return match;
+}
+
+template <CoreConfig Config>
+BasicCPU<Config>::BasicCPU()
+    : cycle_count_(0), instruction_count_(0), branch_mispredictions_(0), moves_eliminated_(0),
+      constants_eliminated_(0), waiting_(false),
+      profiler_(nullptr),
+      checker_(nullptr), syscalls_(nullptr), bus_(nullptr), coherence_(nullptr),
+      misaligned_policy_(MisalignedPolicy::Emulate), macro_fusion_(false) {
+    for (uint64_t &count : fused_pairs_) {
+        count = 0;
+    }
+}
+
+template <CoreConfig Config>
+CPU_Stats BasicCPU<Config>::get_stats() const {
+    CPU_Stats stats;
+    stats.cycles = cycle_count_;
+    stats.instructions = instruction_count_;
+    stats.branch_mispredictions = branch_mispredictions_;
+    return stats;
+}
+
+template <CoreConfig Config>
+void BasicCPU<Config>::set_stats(const CPU_Stats &stats) {
+    cycle_count_ = stats.cycles;
+    instruction_count_ = stats.instructions;
+    branch_mispredictions_ = stats.branch_mispredictions;
+}
+
+template <CoreConfig Config>
+uint32_t BasicCPU<Config>::architectural_pc(const Core &core) {
+    if (core.clear_flag) {
+        return core.next_pc;
+    }
+    if (core.rob_busy.test(core.rob_head)) {
+        return core.rob[core.rob_head].pc;
+    }
+    if (core.fetch_buffer_size > 0) {
+        return core.fetch_buffer[core.fetch_buffer_head].pc;
+    }
+    return core.pc;
+}
+
+template <CoreConfig Config>
+void BasicCPU<Config>::tick(Core &core, uint8_t memory[]) {
+    STAGE_TIMER(stage_timers_, PipelineStage::Tick);
+    Core next_state = core;
+    const uint64_t mispredictions = branch_mispredictions_;
 
-void CPU::tick(CPU_State &cpu) {
-    CPU_Core next_state = cpu.core;
+    commit_stage(core, next_state, memory);
 
-    commit_stage(cpu.core, next_state, cpu.memory);
+    writeback_stage(core, next_state);
+    execute_stage(core, next_state, memory);
 
-    writeback_stage(cpu.core, next_state);
-    execute_stage(cpu.core, next_state, cpu.memory);
+    dispatch_stage(core, next_state);
 
-    dispatch_stage(cpu.core, next_state);
+    decode_rename_stage(core, next_state, memory);
 
-    decode_rename_stage(cpu.core, next_state, cpu.memory);
+    fetch_stage(core, next_state, memory);
 
-    fetch_stage(cpu.core, next_state, cpu.memory);
+    if (profiler_) {
+        profiler_->sample(core, next_state, cycle_count_,
+                          branch_mispredictions_ != mispredictions);
+    }
 
-    cpu.core = next_state;
+    core = next_state;
 
     ++cycle_count_;
     // cout << "CYCLE:" << cycle_count_ << "\n";
 }
 
-void CPU::fetch_stage(const CPU_Core &now_state, CPU_Core &next_state, const uint8_t memory[]) {
+template <CoreConfig Config>
+void BasicCPU<Config>::skip_cycles(const Core &core, uint64_t n) {
+    if (profiler_) {
+        profiler_->skip(core, n);
+    }
+    cycle_count_ += n;
+}
+
+template <CoreConfig Config>
+void BasicCPU<Config>::fetch_stage(const Core &now_state, Core &next_state,
+                                   const uint8_t memory[]) {
+    STAGE_TIMER(stage_timers_, PipelineStage::Fetch);
     int pc = now_state.pc;
     if (now_state.clear_flag) {
         flush_pipeline(next_state);
@@ -37,7 +136,7 @@ void CPU::fetch_stage(const CPU_Core &now_state, CPU_Core &next_state, const uin
         next_state.pc = now_state.next_pc;
         pc = now_state.next_pc;
     }
-    if (now_state.fetch_stalled) {
+    if (now_state.fetch_stalled || now_state.fetch_blocked) {
         return;
     }
 
@@ -45,33 +144,39 @@ void CPU::fetch_stage(const CPU_Core &now_state, CPU_Core &next_state, const uin
         return;
     }
 
-    if (pc < MEMORY_SIZE - 3) {
-
-        uint32_t instruction =
-            memory[pc] | (memory[pc + 1] << 8) | (memory[pc + 2] << 16) | (memory[pc + 3] << 24);
+    uint32_t instruction = 0;
+    bool fetched;
+    {
+        const auto guard = lock_memory_shared();
+        fetched = InstructionProcessor::fetch(memory, pc, instruction);
+    }
 
-        int tail = now_state.fetch_buffer_tail;
-        if (now_state.clear_flag) {
-            tail = 0;
-            next_state.fetch_buffer_size = 0;
-        }
+    int tail = now_state.fetch_buffer_tail;
+    if (now_state.clear_flag) {
+        tail = 0;
+        next_state.fetch_buffer_size = 0;
+    }
 
-        FetchBufferEntry &entry = next_state.fetch_buffer[tail];
-        entry.valid = true;
-        entry.instruction = instruction;
-        entry.pc = pc;
-        next_state.fetch_buffer_tail = (tail + 1) % FETCH_BUFFER_SIZE;
-        next_state.fetch_buffer_size++;
+    FetchBufferEntry &entry = next_state.fetch_buffer[tail];
+    entry.valid = true;
+    entry.instruction = instruction;
+    entry.pc = pc;
+    entry.access_fault = !fetched;
+    next_state.fetch_buffer_tail = ring_next<FETCH_BUFFER_SIZE>(tail);
+    next_state.fetch_buffer_size++;
 
-        next_state.pc = pc + 4;
+    if (fetched) {
+        next_state.pc = pc + (InstructionProcessor::is_compressed(instruction) ? 2 : 4);
     } else {
-
-        next_state.fetch_stalled = true;
+        // 越界的取指可能位于错误路径上，作为异常指令进入ROB，到提交时才引发
+        next_state.fetch_blocked = true;
     }
 }
 
-void CPU::decode_rename_stage(const CPU_Core &now_state, CPU_Core &next_state,
-                              const uint8_t memory[]) {
+template <CoreConfig Config>
+void BasicCPU<Config>::decode_rename_stage(const Core &now_state, Core &next_state,
+                                           const uint8_t memory[]) {
+    STAGE_TIMER(stage_timers_, PipelineStage::Decode);
 
     if (now_state.clear_flag) {
         return;
@@ -90,15 +195,59 @@ void CPU::decode_rename_stage(const CPU_Core &now_state, CPU_Core &next_state,
         return;
     }
 
-    Instruction instr = InstructionProcessor::decode(fetch_entry.instruction, fetch_entry.pc);
+    Instruction faulting;
+    faulting.type = InstrType::ILLEGAL;
+    faulting.pc = fetch_entry.pc;
+    const Instruction &single = fetch_entry.access_fault
+                                    ? faulting
+                                    : predecode(fetch_entry.instruction, fetch_entry.pc);
+
+    // 取指缓存中紧随其后的指令能与本条融合时，两条指令只占一个ROB条目
+    Instruction fused;
+    uint32_t first_value = 0;
+    FusionKind fusion = FusionKind::None;
+    if (macro_fusion_ && !fetch_entry.access_fault && now_state.fetch_buffer_size >= 2) {
+        const FetchBufferEntry &second =
+            now_state.fetch_buffer[ring_next<FETCH_BUFFER_SIZE>(now_state.fetch_buffer_head)];
+        if (second.valid && !second.access_fault && second.pc == single.pc + single.length) {
+            fusion = InstructionProcessor::fuse(single, predecode(second.instruction, second.pc),
+                                                fused, first_value);
+        }
+    } else if (macro_fusion_ && !fetch_entry.access_fault && now_state.fetch_buffer_size == 1 &&
+               !now_state.fetch_stalled && !now_state.fetch_blocked &&
+               now_state.pc == single.pc + single.length) {
+        // 配对的指令本周期才取指：先按内存中的编码判断，能融合时等它进入取指缓存。
+        // 每周期只取一条指令，等待一个周期后一次译码两条，不比逐条译码慢
+        uint32_t raw;
+        bool fetched;
+        {
+            const auto guard = lock_memory_shared();
+            fetched = InstructionProcessor::fetch(memory, now_state.pc, raw);
+        }
+        if (fetched &&
+            InstructionProcessor::fuse(single, predecode(raw, now_state.pc), fused,
+                                       first_value) != FusionKind::None) {
+            return;
+        }
+    }
+    const Instruction &instr = fusion == FusionKind::None ? single : fused;
 
     // cout << "Decode"
     //      << " " << std::hex << " " << fetch_entry.pc << " " << std::dec <<
     //      Type_string(instr.type)
     //      << std::endl;
 
-    if (InstructionProcessor::is_alu_type(instr.type) ||
-        InstructionProcessor::is_branch_type(instr.type)) {
+    // 重命名时消除的指令不占用预约站，也不经过执行单元
+    RenameIdiom idiom = RenameIdiom::None;
+    uint32_t idiom_source = 0;
+    uint32_t idiom_constant = 0;
+    if constexpr (Config.rename_elimination) {
+        idiom = InstructionProcessor::rename_idiom(instr, idiom_source, idiom_constant);
+    }
+
+    if (idiom == RenameIdiom::None && (InstructionProcessor::is_alu_type(instr.type) ||
+                                       InstructionProcessor::is_branch_type(instr.type) ||
+                                       InstructionProcessor::is_muldiv_type(instr.type))) {
         if (!rs_available(now_state, instr.type)) {
             return;
         }
@@ -108,53 +257,98 @@ void CPU::decode_rename_stage(const CPU_Core &now_state, CPU_Core &next_state,
             return;
         }
     }
+    if constexpr (PHYS_REGS != 0) {
+        // 没有空闲的物理寄存器时停止译码，直到提交释放旧的映射
+        if (instr.rd != 0 && writes_register(instr.type) && idiom != RenameIdiom::Move &&
+            next_state.prf.mapped.first_free(PHYS_REGS) == PHYS_REGS) {
+            return;
+        }
+    }
 
     uint32_t rob_idx = now_state.rob_tail;
     if (now_state.clear_flag)
         rob_idx = 0;
-    next_state.rob_tail = (rob_idx + 1) % ROB_SIZE;
+    next_state.rob_tail = ring_next<ROB_SIZE>(rob_idx);
     next_state.rob_size++;
 
     ROBEntry &rob_entry = next_state.rob[rob_idx];
-    rob_entry.busy = true;
+    next_state.rob_busy.set(rob_idx);
+    next_state.rob_state[rob_idx] = InstrState::Dispatch;
     rob_entry.instr_type = instr.type;
-    rob_entry.state = InstrState::Dispatch;
 
     rob_entry.dest_reg = instr.rd;
-    if (InstructionProcessor::is_branch_type(instr.type))
+    if (InstructionProcessor::is_branch_type(instr.type) || instr.type == InstrType::ILLEGAL)
         rob_entry.dest_reg = 0;
 
     rob_entry.pc = instr.pc;
+    rob_entry.length = instr.length;
+    rob_entry.raw = instr.raw;
+    rob_entry.exception = ExceptionCause::None;
+    if (fetch_entry.access_fault) {
+        rob_entry.exception = ExceptionCause::InstructionAccessFault;
+    } else if (instr.type == InstrType::ILLEGAL) {
+        rob_entry.exception = ExceptionCause::IllegalInstruction;
+    } else if (instr.type == InstrType::EBREAK) {
+        rob_entry.exception = ExceptionCause::Breakpoint;
+    }
     rob_entry.rs1 = instr.rs1;
     rob_entry.rs2 = instr.rs2;
     rob_entry.imm = instr.imm;
+    rob_entry.fusion = fusion;
+    rob_entry.first_length = single.length;
+    rob_entry.first_value = first_value;
     //   cout << "Decode" << rob_entry.rs1 << " " << rob_entry.rs2 << " " << rob_entry.imm << "\n ";
     if (InstructionProcessor::is_branch_type(instr.type)) {
         rob_entry.is_branch = true;
         rob_entry.predicted_taken = predict_branch_taken(now_state);
         rob_entry.target_pc = instr.pc + instr.imm;
     }
+    if constexpr (PHYS_REGS != 0) {
+        rob_entry.idiom = idiom;
+        rename_physical(next_state, rob_entry, idiom_source, idiom_constant);
+        if (idiom != RenameIdiom::None) {
+            next_state.rob_state[rob_idx] = InstrState::Commit;
+        }
+    }
 
     fetch_entry.valid = false;
-    next_state.fetch_buffer_head = (now_state.fetch_buffer_head + 1) % FETCH_BUFFER_SIZE;
+    uint32_t head = ring_next<FETCH_BUFFER_SIZE>(now_state.fetch_buffer_head);
     next_state.fetch_buffer_size--;
+    if (fusion != FusionKind::None) {
+        next_state.fetch_buffer[head].valid = false;
+        head = ring_next<FETCH_BUFFER_SIZE>(head);
+        next_state.fetch_buffer_size--;
+    }
+    next_state.fetch_buffer_head = head;
+}
 
-    ++instruction_count_;
+template <CoreConfig Config>
+const Instruction &BasicCPU<Config>::predecode(uint32_t raw, uint32_t pc) {
+    // 以编码本身作为校验，自修改代码不需要额外的失效处理
+    PredecodeEntry &entry = predecode_cache_[(pc >> 1) & (PREDECODE_CACHE_SIZE - 1)];
+    if (!entry.valid || entry.instr.pc != pc || entry.fetched != raw) {
+        entry.valid = true;
+        entry.fetched = raw;
+        entry.instr = InstructionProcessor::decode(raw, pc);
+    }
+    return entry.instr;
 }
 
-void CPU::dispatch_stage(const CPU_Core &now_state, CPU_Core &next_state) {
+template <CoreConfig Config>
+void BasicCPU<Config>::dispatch_stage(const Core &now_state, Core &next_state) {
+    STAGE_TIMER(stage_timers_, PipelineStage::Dispatch);
     if (now_state.clear_flag) {
         return;
     }
 
     for (uint32_t i = 0; i < ROB_SIZE; ++i) {
-        const ROBEntry rob_entry_now = now_state.rob[i];
-
-        if (!rob_entry_now.busy || rob_entry_now.state != InstrState::Dispatch) {
+        if (!now_state.rob_busy.test(i) || now_state.rob_state[i] != InstrState::Dispatch) {
             continue;
         }
+        const ROBEntry &rob_entry_now = now_state.rob[i];
         if (InstructionProcessor::is_alu_type(rob_entry_now.instr_type) ||
-            InstructionProcessor::is_branch_type(rob_entry_now.instr_type)) {
+            InstructionProcessor::is_branch_type(rob_entry_now.instr_type) ||
+            InstructionProcessor::is_muldiv_type(rob_entry_now.instr_type)) {
 
             if (!rs_available(now_state, rob_entry_now.instr_type)) {
                 continue;
@@ -162,12 +356,14 @@ void CPU::dispatch_stage(const CPU_Core &now_state, CPU_Core &next_state) {
 
             uint32_t rs_idx = allocate_rs_entry(now_state, rob_entry_now.instr_type);
             RSEntry &rs_entry = next_state.rs_alu[rs_idx];
-            rs_entry.busy = true;
+            next_state.rs_busy.set(rs_idx);
             rs_entry.op = rob_entry_now.instr_type;
             rs_entry.dest_rob_idx = i;
             rs_entry.imm = rob_entry_now.imm;
+            rs_entry.execution_cycles_left = 0;
             bool ready;
-            rs_entry.Vj = read_operand(now_state, now_state.rob[i].rs1, rs_entry.Qj, ready);
+            rs_entry.Vj = read_source(now_state, next_state, rob_entry_now.rs1,
+                                      rob_entry_now.phys_rs1, next_state.rs_qj[rs_idx], ready);
 
             bool needs_rs2 = false;
             if (InstructionProcessor::is_alu_type(rob_entry_now.instr_type)) {
@@ -175,21 +371,23 @@ void CPU::dispatch_stage(const CPU_Core &now_state, CPU_Core &next_state) {
                 needs_rs2 = (rob_entry_now.instr_type >= InstrType::ALU_ADD &&
                              rob_entry_now.instr_type <= InstrType::ALU_SLTU);
 
-            } else if (InstructionProcessor::is_branch_type(rob_entry_now.instr_type)) {
+            } else if (InstructionProcessor::is_branch_type(rob_entry_now.instr_type) ||
+                       InstructionProcessor::is_muldiv_type(rob_entry_now.instr_type)) {
                 needs_rs2 = true;
             }
 
             if (needs_rs2) {
                 bool ready;
-                rs_entry.Vk = read_operand(now_state, now_state.rob[i].rs2, rs_entry.Qk, ready);
+                rs_entry.Vk = read_source(now_state, next_state, rob_entry_now.rs2,
+                                          rob_entry_now.phys_rs2, next_state.rs_qk[rs_idx], ready);
             } else {
 
                 rs_entry.Vk = 0;
-                rs_entry.Qk = ROB_SIZE;
+                next_state.rs_qk[rs_idx] = NO_ROB_TAG;
             }
 
             rename_registers(next_state, now_state.rob[i], i);
-            next_state.rob[i].state = InstrState::Execute;
+            next_state.rob_state[i] = InstrState::Execute;
         }
 
         else if (InstructionProcessor::is_load_type(rob_entry_now.instr_type) ||
@@ -202,7 +400,7 @@ void CPU::dispatch_stage(const CPU_Core &now_state, CPU_Core &next_state) {
             const uint32_t LSB_idx = allocate_LSB_entry(now_state);
             LSBEntry &LSB_entry = next_state.LSB[LSB_idx];
 
-            LSB_entry.busy = true;
+            next_state.lsb_busy.set(LSB_idx);
             LSB_entry.op = rob_entry_now.instr_type;
             LSB_entry.dest_rob_idx = i;
             LSB_entry.rob_idx = i;
@@ -211,19 +409,13 @@ void CPU::dispatch_stage(const CPU_Core &now_state, CPU_Core &next_state) {
             LSB_entry.execution_cycles_left = 0;
             bool ready = 0;
             LSB_entry.base_value =
-                read_operand(now_state, now_state.rob[i].rs1, LSB_entry.base_rob_idx, ready);
+                read_source(now_state, next_state, rob_entry_now.rs1, rob_entry_now.phys_rs1,
+                            next_state.lsb_base_tag[LSB_idx], ready);
 
             LSB_entry.address_ready = ready;
 
             if (ready) {
-                if (now_state.Regs.is_busy(now_state.rob[i].rs1)) {
-                    uint32_t rob_idx = now_state.Regs.get_rob_index(now_state.rob[i].rs1);
-
-                    LSB_entry.address = now_state.rob[rob_idx].value + rob_entry_now.imm;
-                } else {
-                    LSB_entry.address =
-                        now_state.Regs.get_value(now_state.rob[i].rs1) + rob_entry_now.imm;
-                }
+                LSB_entry.address = LSB_entry.base_value + rob_entry_now.imm;
 
                 //    cout << "ADDR:" << Type_string(LSB_entry.op) << " " << LSB_entry.address << "
                 //    "
@@ -234,17 +426,18 @@ void CPU::dispatch_stage(const CPU_Core &now_state, CPU_Core &next_state) {
             if (InstructionProcessor::is_store_type(rob_entry_now.instr_type)) {
                 bool ready;
                 LSB_entry.value =
-                    read_operand(now_state, now_state.rob[i].rs2, LSB_entry.value_rob_idx, ready);
+                    read_source(now_state, next_state, rob_entry_now.rs2, rob_entry_now.phys_rs2,
+                                next_state.lsb_value_tag[LSB_idx], ready);
 
             } else {
-                LSB_entry.value_rob_idx = ROB_SIZE;
+                next_state.lsb_value_tag[LSB_idx] = NO_ROB_TAG;
             }
 
             if (InstructionProcessor::is_load_type(rob_entry_now.instr_type)) {
                 rename_registers(next_state, now_state.rob[i], i);
             }
 
-            next_state.rob[i].state = InstrState::Execute;
+            next_state.rob_state[i] = InstrState::Execute;
         }
 
         else if (rob_entry_now.instr_type == InstrType::LUI ||
@@ -258,33 +451,46 @@ void CPU::dispatch_stage(const CPU_Core &now_state, CPU_Core &next_state) {
 
             const uint32_t rs_idx = allocate_rs_entry(now_state, rob_entry_now.instr_type);
             RSEntry &rs_entry = next_state.rs_alu[rs_idx];
-            rs_entry.busy = true;
+            next_state.rs_busy.set(rs_idx);
             rs_entry.op = rob_entry_now.instr_type;
             rs_entry.dest_rob_idx = i;
             rs_entry.imm = rob_entry_now.imm;
+            rs_entry.execution_cycles_left = 0;
 
             if (rob_entry_now.instr_type == InstrType::JUMP_JALR) {
                 bool ready;
-                rs_entry.Vj = read_operand(now_state, rob_entry_now.rs1, rs_entry.Qj, ready);
+                rs_entry.Vj = read_source(now_state, next_state, rob_entry_now.rs1,
+                                          rob_entry_now.phys_rs1, next_state.rs_qj[rs_idx], ready);
             } else {
                 rs_entry.Vj = 0;
-                rs_entry.Qj = ROB_SIZE;
+                next_state.rs_qj[rs_idx] = NO_ROB_TAG;
             }
 
             rs_entry.Vk = 0;
-            rs_entry.Qk = ROB_SIZE;
+            next_state.rs_qk[rs_idx] = NO_ROB_TAG;
 
             rename_registers(next_state, rob_entry_now, i);
-            next_state.rob[i].state = InstrState::Execute;
+            next_state.rob_state[i] = InstrState::Execute;
         }
 
-        else if (next_state.rob[i].instr_type == InstrType::HALT) {
-            next_state.rob[i].state = InstrState::Commit;
+        else if (next_state.rob[i].instr_type == InstrType::HALT ||
+                 next_state.rob[i].instr_type == InstrType::ECALL ||
+                 next_state.rob[i].instr_type == InstrType::EBREAK ||
+                 next_state.rob[i].instr_type == InstrType::MRET ||
+                 next_state.rob[i].instr_type == InstrType::WFI ||
+                 next_state.rob[i].instr_type == InstrType::FENCE ||
+                 next_state.rob[i].instr_type == InstrType::ILLEGAL ||
+                 InstructionProcessor::is_csr_type(next_state.rob[i].instr_type) ||
+                 InstructionProcessor::is_atomic_type(next_state.rob[i].instr_type)) {
+            next_state.rob_state[i] = InstrState::Commit;
         }
     }
 }
 
-void CPU::execute_stage(const CPU_Core &now_state, CPU_Core &next_state, const uint8_t memory[]) {
+template <CoreConfig Config>
+void BasicCPU<Config>::execute_stage(const Core &now_state, Core &next_state,
+                                     const uint8_t memory[]) {
+    STAGE_TIMER(stage_timers_, PipelineStage::Execute);
     if (now_state.clear_flag) {
         return;
     }
@@ -292,11 +498,14 @@ void CPU::execute_stage(const CPU_Core &now_state, CPU_Core &next_state, const u
     uint32_t alu_units_used = 0;
     uint32_t load_units_used = 0;
 
-    for (uint32_t i = 0; i < RS_SIZE && alu_units_used < MAX_ALU_UNITS; ++i) {
+    // 按下标从小到大遍历占用且操作数就绪的条目
+    for (uint64_t ready = ready_entries(now_state); ready && alu_units_used < MAX_ALU_UNITS;
+         ready &= ready - 1) {
+        const uint32_t i = std::countr_zero(ready);
         RSEntry &rs_entry = next_state.rs_alu[i];
-        const RSEntry rs_entry_now = now_state.rs_alu[i];
+        const RSEntry &rs_entry_now = now_state.rs_alu[i];
 
-        if (!rs_entry_now.busy || !rs_entry_now.operands_ready()) {
+        if (InstructionProcessor::is_muldiv_type(rs_entry_now.op)) {
             continue;
         }
         //  cout << "EXCUTE"
@@ -311,7 +520,7 @@ void CPU::execute_stage(const CPU_Core &now_state, CPU_Core &next_state, const u
         if (rs_entry_now.execution_cycles_left == 0) {
             uint32_t result = 0;
             ROBEntry &rob_entry = next_state.rob[rs_entry_now.dest_rob_idx];
-            const ROBEntry rob_entry_now = now_state.rob[rs_entry_now.dest_rob_idx];
+            const ROBEntry &rob_entry_now = now_state.rob[rs_entry_now.dest_rob_idx];
 
             if (InstructionProcessor::is_alu_type(rs_entry_now.op) ||
                 rs_entry_now.op == InstrType::LUI || rs_entry_now.op == InstrType::AUIPC ||
@@ -322,7 +531,7 @@ void CPU::execute_stage(const CPU_Core &now_state, CPU_Core &next_state, const u
 
                     if (rs_entry_now.op == InstrType::JUMP_JAL ||
                         rs_entry_now.op == InstrType::JUMP_JALR) {
-                        result = rob_entry_now.pc + 4;
+                        result = rob_entry_now.pc + rob_entry_now.length;
 
                         if (rs_entry_now.op == InstrType::JUMP_JAL) {
                             rob_entry.target_pc = rob_entry_now.pc + rs_entry_now.imm;
@@ -347,28 +556,29 @@ void CPU::execute_stage(const CPU_Core &now_state, CPU_Core &next_state, const u
                 if (taken) {
                     rob_entry.target_pc = rob_entry_now.pc + rob_entry_now.imm;
                 } else {
-                    rob_entry.target_pc = rob_entry_now.pc + 4;
+                    rob_entry.target_pc = rob_entry_now.pc + rob_entry_now.length;
                 }
 
                 result = taken ? 1 : 0;
             }
 
             rob_entry.value = result;
-            rob_entry.state = InstrState::Writeback;
+            next_state.rob_state[rs_entry_now.dest_rob_idx] = InstrState::Writeback;
 
-            rs_entry.busy = false;
+            next_state.rs_busy.reset(i);
         }
     }
 
-    for (uint32_t i = 0; i < LSB_SIZE && load_units_used < MAX_LOAD_UNITS; ++i) {
+    execute_muldiv(now_state, next_state);
+
+    for (uint64_t busy = now_state.lsb_busy.bits; busy && load_units_used < MAX_LOAD_UNITS;
+         busy &= busy - 1) {
+        const uint32_t i = std::countr_zero(busy);
         LSBEntry &LSB_entry = next_state.LSB[i];
-        const LSBEntry LSB_entry_now = now_state.LSB[i];
-        if (!LSB_entry_now.busy) {
-            continue;
-        }
+        const LSBEntry &LSB_entry_now = now_state.LSB[i];
         bool address_ready = 0;
         if (!LSB_entry_now.address_ready) {
-            if (LSB_entry_now.base_rob_idx == ROB_SIZE) {
+            if (now_state.lsb_base_tag[i] == NO_ROB_TAG) {
                 LSB_entry.address = LSB_entry_now.base_value + LSB_entry_now.offset;
                 //     cout << "ADDR::" << Type_string(LSB_entry.op) << " " << LSB_entry.address <<
                 //     " "
@@ -387,28 +597,56 @@ void CPU::execute_stage(const CPU_Core &now_state, CPU_Core &next_state, const u
             continue;
         }
 
+        const uint32_t access_size = InstructionProcessor::get_access_size(LSB_entry_now.op);
+        const bool is_load = InstructionProcessor::is_load_type(LSB_entry_now.op);
+        ExceptionCause fault = ExceptionCause::None;
+        if (misaligned_policy_ == MisalignedPolicy::Trap &&
+            !MemoryAccess::is_aligned(LSB_entry_now.address, access_size)) {
+            fault = is_load ? ExceptionCause::LoadAddressMisaligned
+                            : ExceptionCause::StoreAddressMisaligned;
+        } else if (!Bus::is_ram(LSB_entry_now.address, access_size) &&
+                   !(bus_ && bus_->is_mapped(LSB_entry_now.address, access_size))) {
+            fault = is_load ? ExceptionCause::LoadAccessFault : ExceptionCause::StoreAccessFault;
+        }
+        if (fault != ExceptionCause::None) {
+            // 不访问内存，异常随ROB条目在提交时引发
+            ROBEntry &rob_entry = next_state.rob[LSB_entry_now.dest_rob_idx];
+            rob_entry.exception = fault;
+            rob_entry.mem_address = LSB_entry_now.address;
+            next_state.rob_state[LSB_entry_now.dest_rob_idx] = InstrState::Writeback;
+            LSB_entry.execute_completed = true;
+            continue;
+        }
+
         // cout << "EXCUTELSB::;"
         //       << " " << Type_string(LSB_entry_now.op) << " "
         //       << now_state.rob[LSB_entry_now.rob_idx].pc << " " << LSB_entry_now.rob_idx << "\n";
-        if (InstructionProcessor::is_load_type(LSB_entry_now.op)) {
+        if (is_load) {
             //     cout << "GGG:" << LSB_entry_now.address_ready << " "
             //       << " " << LSB_entry_now.value_rob_idx << "\n";
+            const bool is_ram = Bus::is_ram(LSB_entry_now.address, access_size);
             if (LSB_entry_now.execution_cycles_left == 0) {
+                // 设备读可能有副作用，必须等到成为ROB头部、不会再被冲刷时才访问
+                if (!is_ram && LSB_entry_now.rob_idx != now_state.rob_head) {
+                    continue;
+                }
                 uint32_t forwarded_value;
-                if (get_load_values(now_state, LSB_entry_now.address, LSB_entry_now.rob_idx,
-                                    forwarded_value)) {
+                if (get_load_values(now_state, LSB_entry_now, forwarded_value)) {
                     ROBEntry &rob_entry = next_state.rob[LSB_entry_now.dest_rob_idx];
 
                     rob_entry.value = forwarded_value;
-                    rob_entry.state = InstrState::Writeback;
+                    next_state.rob_state[LSB_entry_now.dest_rob_idx] = InstrState::Writeback;
                     LSB_entry.execute_completed = true;
                     load_units_used++;
-                    LSB_entry.busy = false;
+                    next_state.lsb_busy.reset(i);
 
                     continue;
-                } else if (check_load_dependencies(now_state, LSB_entry_now.address,
-                                                   LSB_entry_now.rob_idx, forwarded_value)) {
+                } else if (check_load_dependencies(now_state, LSB_entry_now)) {
                     LSB_entry.execution_cycles_left = 3;
+                    if (coherence_ && is_ram) {
+                        LSB_entry.execution_cycles_left += coherence_->access(
+                            now_state.csr.mhartid, LSB_entry_now.address, false);
+                    }
                 } else
                     continue;
             }
@@ -419,87 +657,139 @@ void CPU::execute_stage(const CPU_Core &now_state, CPU_Core &next_state, const u
                 load_units_used++;
 
                 if (LSB_entry_now.execution_cycles_left == 1) {
-                    if (LSB_entry_now.address < MEMORY_SIZE) {
-                        uint32_t value = 0;
-                        switch (LSB_entry_now.op) {
-                        case InstrType::LOAD_LB:
-                            value = static_cast<int32_t>(
-                                static_cast<int8_t>(memory[LSB_entry_now.address]));
-                            break;
-                        case InstrType::LOAD_LBU:
-                            value = memory[LSB_entry_now.address];
-                            break;
-                        case InstrType::LOAD_LH:
-                            value = static_cast<int32_t>(
-                                static_cast<int16_t>(*reinterpret_cast<const uint16_t *>(
-                                    &memory[LSB_entry_now.address])));
-                            break;
-                        case InstrType::LOAD_LHU:
-                            value =
-                                *reinterpret_cast<const uint16_t *>(&memory[LSB_entry_now.address]);
-                            break;
-                        case InstrType::LOAD_LW:
-                            value =
-                                *reinterpret_cast<const uint32_t *>(&memory[LSB_entry_now.address]);
-                            //      cout << "LW"
-                            //           << " " << LSB_entry_now.address << " " << value <<
-                            //           std::endl;
-                            break;
-                        default:
-                            value = 0;
-                            break;
-                        }
-
-                        ROBEntry &rob_entry = next_state.rob[LSB_entry_now.dest_rob_idx];
-                        rob_entry.value = value;
-                        rob_entry.state = InstrState::Writeback;
-                        LSB_entry.execute_completed = true;
-                        LSB_entry.busy = false;
+                    uint32_t value = 0;
+                    if (is_ram) {
+                        const auto guard = lock_memory_shared();
+                        value = InstructionProcessor::extend_load(
+                            LSB_entry_now.op,
+                            MemoryAccess::read(memory, LSB_entry_now.address, access_size));
+                    } else if (bus_) {
+                        bus_->read(LSB_entry_now.address, access_size, value);
+                        value = InstructionProcessor::extend_load(LSB_entry_now.op, value);
                     }
+
+                    ROBEntry &rob_entry = next_state.rob[LSB_entry_now.dest_rob_idx];
+                    rob_entry.value = value;
+                    next_state.rob_state[LSB_entry_now.dest_rob_idx] = InstrState::Writeback;
+                    LSB_entry.execute_completed = true;
+                    next_state.lsb_busy.reset(i);
                 }
             }
         } else if (InstructionProcessor::is_store_type(LSB_entry_now.op)) {
 
             bool value_ready = 0;
-            if (LSB_entry_now.value_rob_idx != ROB_SIZE) {
-
-                const ROBEntry value_rob = now_state.rob[LSB_entry_now.value_rob_idx];
+            const uint32_t value_tag = now_state.lsb_value_tag[i];
+            if (value_tag != NO_ROB_TAG) {
 
-                if (value_rob.state >= InstrState::Writeback) {
-
-                    LSB_entry.value = value_rob.value;
-                    LSB_entry.value_rob_idx = ROB_SIZE;
+                if (result_ready(now_state, value_tag, LSB_entry.value)) {
+                    next_state.lsb_value_tag[i] = NO_ROB_TAG;
                     value_ready = 1;
                 }
             }
 
-            if (LSB_entry_now.address_ready &&
-                (LSB_entry_now.value_rob_idx == ROB_SIZE || value_ready)) {
+            if (LSB_entry_now.address_ready && (value_tag == NO_ROB_TAG || value_ready)) {
                 load_units_used++;
                 ROBEntry &rob_entry = next_state.rob[LSB_entry_now.dest_rob_idx];
                 rob_entry.value = 0;
-                rob_entry.state = InstrState::Writeback;
+                next_state.rob_state[LSB_entry_now.dest_rob_idx] = InstrState::Writeback;
                 LSB_entry.execute_completed = true;
             }
         }
     }
 }
 
-void CPU::writeback_stage(const CPU_Core &now_state, CPU_Core &next_state) {
-    if (now_state.clear_flag) {
-        return;
+template <CoreConfig Config>
+void BasicCPU<Config>::execute_muldiv(const Core &now_state, Core &next_state) {
+    // 乘法器流水化，每周期可以接收一条新的乘法；除法器为迭代实现，同一时刻只执行一条
+    uint32_t mul_issued = 0;
+    uint32_t div_issued = 0;
+    for (uint32_t i = 0; i < RS_SIZE; ++i) {
+        const RSEntry &rs_entry_now = now_state.rs_alu[i];
+        if (now_state.rs_busy.test(i) && rs_entry_now.execution_cycles_left > 0 &&
+            InstructionProcessor::is_div_type(rs_entry_now.op)) {
+            ++div_issued;
+        }
     }
-    for (uint32_t i = 0; i < ROB_SIZE; ++i) {
 
-        const ROBEntry rob_entry_now = now_state.rob[i];
-        if (rob_entry_now.busy && rob_entry_now.state == InstrState::Writeback) {
+    for (uint32_t i = 0; i < RS_SIZE; ++i) {
+        RSEntry &rs_entry = next_state.rs_alu[i];
+        const RSEntry &rs_entry_now = now_state.rs_alu[i];
+        if (!now_state.rs_busy.test(i) || !InstructionProcessor::is_muldiv_type(rs_entry_now.op)) {
+            continue;
+        }
+
+        if (rs_entry_now.execution_cycles_left == 0) {
+            if (!now_state.rs_ready(i)) {
+                continue;
+            }
+            if (InstructionProcessor::is_mul_type(rs_entry_now.op)) {
+                if (mul_issued >= MAX_MUL_UNITS) {
+                    continue;
+                }
+                ++mul_issued;
+            } else {
+                if (div_issued >= MAX_DIV_UNITS) {
+                    continue;
+                }
+                ++div_issued;
+            }
+            const int latency = InstructionProcessor::get_execution_cycles(rs_entry_now.op);
+            if (latency > 1) {
+                rs_entry.execution_cycles_left = latency - 1;
+                continue;
+            }
+        } else {
+            rs_entry.execution_cycles_left = rs_entry_now.execution_cycles_left - 1;
+            if (rs_entry_now.execution_cycles_left > 1) {
+                continue;
+            }
+        }
+
+        ROBEntry &rob_entry = next_state.rob[rs_entry_now.dest_rob_idx];
+        rob_entry.value = InstructionProcessor::execute_alu(rs_entry_now.op, rs_entry_now.Vj,
+                                                            rs_entry_now.Vk, rs_entry_now.imm);
+        next_state.rob_state[rs_entry_now.dest_rob_idx] = InstrState::Writeback;
+        next_state.rs_busy.reset(i);
+    }
+}
 
-            broadcast_result(now_state, next_state, i, rob_entry_now.value);
+template <CoreConfig Config>
+void BasicCPU<Config>::writeback_stage(const Core &now_state, Core &next_state) {
+    STAGE_TIMER(stage_timers_, PipelineStage::Writeback);
+    if (now_state.clear_flag) {
+        return;
+    }
+    // 本周期写回的结果先全部放上CDB，再一次性与各队列的标签比较
+    CDB cdb;
+    for (uint64_t busy = now_state.rob_busy.bits; busy; busy &= busy - 1) {
+        const uint32_t i = std::countr_zero(busy);
+        if (now_state.rob_state[i] != InstrState::Writeback) {
+            continue;
         }
+        next_state.rob_state[i] = InstrState::Commit;
+        const ROBEntry &entry = now_state.rob[i];
+        uint32_t tag = i;
+        if constexpr (PHYS_REGS != 0) {
+            tag = entry.phys_dest;
+            if (tag == NO_ROB_TAG) {
+                continue;
+            }
+            next_state.prf.value[tag] = entry.value;
+            next_state.prf.ready.set(tag);
+        }
+        cdb.tag[cdb.count++] = tag;
+        cdb.value[tag] = entry.value;
+    }
+    if (cdb.count) {
+        broadcast_results(now_state, next_state, cdb);
     }
 }
 
-void CPU::commit_stage(const CPU_Core &now_state, CPU_Core &next_state, uint8_t memory[]) {
+template <CoreConfig Config>
+void BasicCPU<Config>::commit_stage(const Core &now_state, Core &next_state, uint8_t memory[]) {
+    STAGE_TIMER(stage_timers_, PipelineStage::Commit);
+    waiting_ = false;
+    next_state.csr.mip = bus_ ? bus_->get_pending_interrupts(next_state.csr.mhartid) : 0;
     if (now_state.clear_flag) {
         return;
     }
@@ -508,57 +798,172 @@ void CPU::commit_stage(const CPU_Core &now_state, CPU_Core &next_state, uint8_t
         return;
     }
 
-    const ROBEntry rob_entry_now = now_state.rob[now_state.rob_head];
+    const ROBEntry &rob_entry_now = now_state.rob[now_state.rob_head];
+    const bool head_busy = now_state.rob_busy.test(now_state.rob_head);
+    const InstrState head_state = now_state.rob_state[now_state.rob_head];
+
+    const uint32_t interrupt = CSRProcessor::pending_interrupt(next_state.csr);
+    if (interrupt && head_busy && interruptible(rob_entry_now, head_state)) {
+        take_interrupt(now_state, next_state, interrupt, rob_entry_now.pc);
+        return;
+    }
 
-    if (!rob_entry_now.busy || rob_entry_now.state != InstrState::Commit) {
+    if (!head_busy || head_state != InstrState::Commit) {
         return;
     }
     //  cout << "Commit:" << Type_string(rob_entry_now.instr_type) << "\n";
+    if (rob_entry_now.exception != ExceptionCause::None) {
+        raise_exception(next_state, rob_entry_now, rob_entry_now.exception);
+        return;
+    }
+
     if (rob_entry_now.instr_type == InstrType::HALT) {
         next_state.fetch_stalled = true;
         return;
     }
 
+    if constexpr (Config.rename_elimination) {
+        if (rob_entry_now.idiom != RenameIdiom::None) {
+            // 结果已在目标物理寄存器中：复制的源指令更早，提交前已经写回
+            ROBEntry committed = rob_entry_now;
+            committed.value = now_state.prf.value[committed.phys_dest];
+            check_commit(now_state, committed, nullptr);
+            next_state.Regs.set_value(committed.dest_reg, committed.value);
+            retire_physical(next_state, committed);
+            if (committed.idiom == RenameIdiom::Move) {
+                ++moves_eliminated_;
+            } else {
+                ++constants_eliminated_;
+            }
+            free_rob_entry(next_state);
+            return;
+        }
+    }
+
+    if (rob_entry_now.instr_type == InstrType::ECALL &&
+        CSRProcessor::traps_enabled(next_state.csr)) {
+        // 设置了陷入处理程序时ECALL交由客户程序处理，否则由模拟器代为执行系统调用
+        raise_exception(next_state, rob_entry_now, ExceptionCause::EnvironmentCallFromM);
+        return;
+    }
+
+    if (rob_entry_now.instr_type == InstrType::ECALL) {
+        // 此时更早的指令都已提交，寄存器堆即为架构状态；执行后冲刷流水线，
+        // 后续读取a0的指令重新取指，保证系统调用的效果精确可见
+        ROBEntry committed = rob_entry_now;
+        if (syscalls_) {
+            // read、write系统调用直接读写客户内存
+            std::unique_lock<std::shared_mutex> guard;
+            if (coherence_) {
+                guard = std::unique_lock<std::shared_mutex>(coherence_->memory_lock());
+            }
+            syscalls_->handle(next_state.Regs, memory);
+            committed.value = next_state.Regs.get_value(10);
+            if (syscalls_->has_exited()) {
+                next_state.fetch_stalled = true;
+            }
+        }
+        check_commit(now_state, committed, nullptr);
+        serialize_pipeline(next_state, rob_entry_now.pc + rob_entry_now.length);
+        return;
+    }
+
+    if (InstructionProcessor::is_csr_type(rob_entry_now.instr_type)) {
+        // 与ECALL相同，在提交时读写CSR并冲刷流水线，计数器读出的即提交时刻的值
+        ROBEntry committed = rob_entry_now;
+        const bool immediate = rob_entry_now.instr_type >= InstrType::CSRRWI;
+        const uint32_t operand =
+            immediate ? rob_entry_now.rs1 : next_state.Regs.get_value(rob_entry_now.rs1);
+        CSRCounters counters;
+        counters.cycle = cycle_count_;
+        counters.instret = instruction_count_;
+        if (!CSRProcessor::execute(next_state.csr, counters, rob_entry_now.instr_type,
+                                   rob_entry_now.imm, rob_entry_now.rs1, operand,
+                                   committed.value)) {
+            raise_exception(next_state, rob_entry_now, ExceptionCause::IllegalInstruction);
+            return;
+        }
+        next_state.Regs.set_value(rob_entry_now.dest_reg, committed.value);
+        check_commit(now_state, committed, nullptr);
+        serialize_pipeline(next_state, rob_entry_now.pc + rob_entry_now.length);
+        return;
+    }
+
+    if (InstructionProcessor::is_atomic_type(rob_entry_now.instr_type)) {
+        if (commit_atomic(now_state, next_state, memory)) {
+            serialize_pipeline(next_state, rob_entry_now.pc + rob_entry_now.length);
+        }
+        return;
+    }
+
+    if (rob_entry_now.instr_type == InstrType::MRET) {
+        check_commit(now_state, rob_entry_now, nullptr);
+        serialize_pipeline(next_state, CSRProcessor::return_from_trap(next_state.csr));
+        return;
+    }
+
+    if (rob_entry_now.instr_type == InstrType::WFI) {
+        // 有等待处理的中断（不论mstatus.MIE）时WFI按NOP提交，否则停在ROB头部
+        if (!(next_state.csr.mip & next_state.csr.mie)) {
+            waiting_ = true;
+            return;
+        }
+        check_commit(now_state, rob_entry_now, nullptr);
+        serialize_pipeline(next_state, rob_entry_now.pc + rob_entry_now.length);
+        return;
+    }
+
+    if (rob_entry_now.instr_type == InstrType::FENCE) {
+        // 单核且按序写内存，FENCE只需冲刷流水线，使FENCE.I之后重新取指
+        check_commit(now_state, rob_entry_now, nullptr);
+        serialize_pipeline(next_state, rob_entry_now.pc + rob_entry_now.length);
+        return;
+    }
+
     if (InstructionProcessor::is_store_type(rob_entry_now.instr_type)) {
 
         for (uint32_t i = 0; i < LSB_SIZE; ++i) {
-            const LSBEntry LSB_entry_now = now_state.LSB[i];
+            const LSBEntry &LSB_entry_now = now_state.LSB[i];
             LSBEntry &LSB_entry = next_state.LSB[i];
-            if (LSB_entry_now.busy && LSB_entry_now.rob_idx == now_state.rob_head &&
+            if (now_state.lsb_busy.test(i) && LSB_entry_now.rob_idx == now_state.rob_head &&
                 LSB_entry_now.execute_completed) {
 
                 if (LSB_entry_now.execution_cycles_left == 0) {
 
                     LSB_entry.execution_cycles_left = 3;
+                    if (coherence_ && Bus::is_ram(LSB_entry_now.address, 1)) {
+                        LSB_entry.execution_cycles_left += coherence_->access(
+                            now_state.csr.mhartid, LSB_entry_now.address, true);
+                    }
                 }
 
                 LSB_entry.execution_cycles_left--;
 
                 if (LSB_entry_now.execution_cycles_left == 1) {
-                    if (LSB_entry_now.address < MEMORY_SIZE &&
-                        LSB_entry_now.value_rob_idx == ROB_SIZE) {
+                    const uint32_t access_size =
+                        InstructionProcessor::get_access_size(LSB_entry_now.op);
+                    if (Bus::is_ram(LSB_entry_now.address, access_size) &&
+                        now_state.lsb_value_tag[i] == NO_ROB_TAG) {
                         //     cout << "store" << Type_string(LSB_entry_now.op) << " "
                         //         << LSB_entry_now.address << " " << LSB_entry_now.value <<
                         //         std::endl;
-                        switch (LSB_entry_now.op) {
-                        case InstrType::STORE_SB:
-                            memory[LSB_entry_now.address] =
-                                static_cast<uint8_t>(LSB_entry_now.value);
-                            break;
-                        case InstrType::STORE_SH:
-                            *reinterpret_cast<uint16_t *>(&memory[LSB_entry_now.address]) =
-                                static_cast<uint16_t>(LSB_entry_now.value);
-                            break;
-                        case InstrType::STORE_SW:
-                            *reinterpret_cast<uint32_t *>(&memory[LSB_entry_now.address]) =
-                                LSB_entry_now.value;
-                            break;
-                        default:
-                            break;
+                        if (coherence_) {
+                            std::lock_guard<std::shared_mutex> guard(coherence_->memory_lock());
+                            MemoryAccess::write(memory, LSB_entry_now.address, access_size,
+                                                LSB_entry_now.value);
+                        } else {
+                            MemoryAccess::write(memory, LSB_entry_now.address, access_size,
+                                                LSB_entry_now.value);
+                        }
+                    } else if (bus_ && now_state.lsb_value_tag[i] == NO_ROB_TAG) {
+                        bus_->write(LSB_entry_now.address, access_size, LSB_entry_now.value);
+                        if (bus_->has_exited()) {
+                            next_state.fetch_stalled = true;
                         }
                     }
 
-                    LSB_entry.busy = false;
+                    check_commit(now_state, rob_entry_now, &LSB_entry_now);
+                    next_state.lsb_busy.reset(i);
                     free_rob_entry(next_state);
                 }
                 return;
@@ -566,12 +971,22 @@ void CPU::commit_stage(const CPU_Core &now_state, CPU_Core &next_state, uint8_t
         }
     }
 
+    check_commit(now_state, rob_entry_now, nullptr);
+    if (rob_entry_now.fusion != FusionKind::None) {
+        // 融合的指令对按两条指令计数
+        ++instruction_count_;
+        ++fused_pairs_[static_cast<uint32_t>(rob_entry_now.fusion)];
+    }
+
     if (rob_entry_now.dest_reg != 0 &&
         !InstructionProcessor::is_branch_type(rob_entry_now.instr_type)) {
         next_state.Regs.set_value(rob_entry_now.dest_reg, rob_entry_now.value);
         //    cout << "COMMIT" << rob_entry_now.dest_reg << " " << rob_entry_now.value << std::endl;
 
-        if (now_state.Regs.check_buzy(rob_entry_now.dest_reg, now_state.rob_head)) {
+        if constexpr (PHYS_REGS != 0) {
+            // Regs仍按架构寄存器保存提交的值，供系统调用、CSR与差分检查读取
+            retire_physical(next_state, rob_entry_now);
+        } else if (now_state.Regs.check_buzy(rob_entry_now.dest_reg, now_state.rob_head)) {
             next_state.Regs.clear_busy(rob_entry_now.dest_reg);
         }
     }
@@ -596,86 +1011,348 @@ void CPU::commit_stage(const CPU_Core &now_state, CPU_Core &next_state, uint8_t
     free_rob_entry(next_state);
 }
 
+template <CoreConfig Config>
+bool BasicCPU<Config>::commit_atomic(const Core &now_state, Core &next_state, uint8_t memory[]) {
+    // 与CSR指令相同，更早的指令都已提交，直接读架构寄存器
+    ROBEntry committed = now_state.rob[now_state.rob_head];
+    const InstrType op = committed.instr_type;
+    const uint32_t address = next_state.Regs.get_value(committed.rs1);
+    const uint32_t operand = next_state.Regs.get_value(committed.rs2);
+    committed.mem_address = address;
+    if (!MemoryAccess::is_aligned(address, 4)) {
+        raise_exception(next_state, committed,
+                        op == InstrType::LR_W ? ExceptionCause::LoadAddressMisaligned
+                                              : ExceptionCause::StoreAddressMisaligned);
+        return false;
+    }
+    if (!Bus::is_ram(address, 4)) {
+        raise_exception(next_state, committed,
+                        op == InstrType::LR_W ? ExceptionCause::LoadAccessFault
+                                              : ExceptionCause::StoreAccessFault);
+        return false;
+    }
+
+    const uint32_t hart = next_state.csr.mhartid;
+    std::unique_lock<std::shared_mutex> guard;
+    if (coherence_) {
+        guard = std::unique_lock<std::shared_mutex>(coherence_->memory_lock());
+    }
+
+    LSBEntry store;
+    store.address = address;
+    bool stored = false;
+    if (op == InstrType::LR_W) {
+        if (coherence_) {
+            coherence_->access(hart, address, false);
+        }
+        committed.value = MemoryAccess::read(memory, address, 4);
+        next_state.reservation_valid = true;
+        next_state.reservation_address = address;
+    } else if (op == InstrType::SC_W) {
+        // 其他hart写过该行时本hart的副本已失效，保留随之失效
+        const bool reserved = now_state.reservation_valid &&
+                              now_state.reservation_address == address &&
+                              (!coherence_ || coherence_->holds(hart, address));
+        next_state.reservation_valid = false;
+        committed.value = reserved ? 0 : 1;
+        if (reserved) {
+            store.value = operand;
+            stored = true;
+        }
+    } else {
+        committed.value = MemoryAccess::read(memory, address, 4);
+        store.value = InstructionProcessor::execute_amo(op, committed.value, operand);
+        stored = true;
+    }
+    if (stored) {
+        if (coherence_) {
+            coherence_->access(hart, address, true);
+        }
+        MemoryAccess::write(memory, address, 4, store.value);
+    }
+    if (guard.owns_lock()) {
+        guard.unlock();
+    }
+
+    next_state.Regs.set_value(committed.dest_reg, committed.value);
+    check_commit(now_state, committed, stored ? &store : nullptr);
+    return true;
+}
+
+template <CoreConfig Config>
+void BasicCPU<Config>::raise_exception(Core &next_state, const ROBEntry &entry,
+                                       ExceptionCause cause) {
+    // 精确异常：更早的指令均已提交，本条及之后的指令都不提交
+    uint32_t tval;
+    switch (cause) {
+    case ExceptionCause::InstructionAccessFault:
+    case ExceptionCause::Breakpoint:
+        tval = entry.pc;
+        break;
+    case ExceptionCause::IllegalInstruction:
+        tval = entry.raw;
+        break;
+    case ExceptionCause::EnvironmentCallFromM:
+        tval = 0;
+        break;
+    default:
+        tval = entry.mem_address;
+        break;
+    }
+
+    if (CSRProcessor::traps_enabled(next_state.csr)) {
+        // 陷入处理程序：本条指令不退休，不增加instret；参考模型同样在这一步进入陷入
+        ROBEntry trapped = entry;
+        trapped.dest_reg = 0;
+        check_commit(next_state, trapped, nullptr);
+        next_state.next_pc = CSRProcessor::enter_trap(next_state.csr,
+                                                      static_cast<uint32_t>(cause), entry.pc,
+                                                      tval);
+        flush_pipeline(next_state);
+        return;
+    }
+
+    exception_.cause = cause;
+    exception_.pc = entry.pc;
+    exception_.tval = tval;
+    exception_.hart = next_state.csr.mhartid;
+    next_state.fetch_stalled = true;
+}
+
+template <CoreConfig Config>
+void BasicCPU<Config>::take_interrupt(const Core &now_state, Core &next_state, uint32_t cause,
+                                      uint32_t pc) {
+    if (checker_) {
+        checker_->on_interrupt(cause, pc, now_state.Regs, cycle_count_);
+    }
+    next_state.next_pc = CSRProcessor::enter_trap(next_state.csr, cause, pc, 0);
+    flush_pipeline(next_state);
+}
+
+template <CoreConfig Config>
+bool BasicCPU<Config>::interruptible(const ROBEntry &head, InstrState state) {
+    if (head.instr_type == InstrType::WFI) {
+        return false;
+    }
+    return !InstructionProcessor::is_load_type(head.instr_type) ||
+           state == InstrState::Dispatch || state == InstrState::Execute;
+}
+
+template <CoreConfig Config>
+void BasicCPU<Config>::check_commit(const Core &now_state, const ROBEntry &entry,
+                                    const LSBEntry *store) {
+    if (!checker_) {
+        return;
+    }
+    CommitRecord record;
+    record.pc = entry.pc;
+    record.type = entry.instr_type;
+    record.dest_reg = entry.dest_reg;
+    record.value = entry.value;
+    record.is_store = store != nullptr;
+    record.store_address = store ? store->address : 0;
+    record.store_value = store ? store->value : 0;
+    if (entry.fusion != FusionKind::None) {
+        // 融合的指令对按原来的两条指令分别与参考模型比较
+        CommitRecord first = record;
+        switch (entry.fusion) {
+        case FusionKind::LuiAddi:
+            first.type = InstrType::LUI;
+            record.type = InstrType::ALU_ADDI;
+            break;
+        case FusionKind::AuipcJalr:
+            first.type = InstrType::AUIPC;
+            record.type = InstrType::JUMP_JALR;
+            break;
+        default:
+            first.type = InstrType::ALU_SLLI;
+            record.type = InstrType::ALU_SRLI;
+            break;
+        }
+        // slli的结果左移k位后与andi的结果相同，k由掩码前导零的个数得到
+        first.value = entry.fusion == FusionKind::SlliSrli
+                          ? entry.value << std::countl_zero(static_cast<uint32_t>(entry.imm))
+                          : entry.first_value;
+        if (!checker_->on_commit(first, now_state.Regs, cycle_count_)) {
+            return;
+        }
+        record.pc = entry.pc + entry.first_length;
+    }
+    checker_->on_commit(record, now_state.Regs, cycle_count_);
+}
+
 void print(CPU_Core &cpu) {
     CNT++;
     cout << CNT << "\n";
     cpu.Regs.print_status();
 }
 
-bool CPU::rob_full(const CPU_Core &cpu) const {
+template <CoreConfig Config>
+bool BasicCPU<Config>::rob_full(const Core &cpu) const {
     //   cout << "ROBFULL" << cpu.rob_size << " " << cpu.commit_flag << " "
     //        << "\n";
     return ((cpu.rob_size >= ROB_SIZE - 1) && (!cpu.commit_flag));
 }
 
-bool CPU::rob_empty(const CPU_Core &cpu) const { return (cpu.rob_size - cpu.commit_flag) == 0; }
+template <CoreConfig Config>
+bool BasicCPU<Config>::rob_empty(const Core &cpu) const {
+    return (cpu.rob_size - cpu.commit_flag) == 0;
+}
 
-void CPU::free_rob_entry(CPU_Core &cpu) {
+template <CoreConfig Config>
+void BasicCPU<Config>::free_rob_entry(Core &cpu) {
     // print(cpu);
+    ++instruction_count_;
     cpu.commit_flag = 1;
-    cpu.rob[cpu.rob_head].busy = false;
-    cpu.rob_head = (cpu.rob_head + 1) % ROB_SIZE;
+    cpu.rob_busy.reset(cpu.rob_head);
+    cpu.rob_head = ring_next<ROB_SIZE>(cpu.rob_head);
 }
 
-bool CPU::rs_available(const CPU_Core &cpu, InstrType type) const {
-    for (uint32_t i = 0; i < RS_SIZE; ++i) {
-        if (!cpu.rs_alu[i].busy) {
-            return true;
-        }
-    }
-    return false;
+template <CoreConfig Config> uint64_t BasicCPU<Config>::ready_entries(const Core &cpu) {
+    const RobTag no_tag = NO_ROB_TAG;
+    return match_tags<RS_SIZE>(cpu.rs_qj, &no_tag, 1) &
+           match_tags<RS_SIZE>(cpu.rs_qk, &no_tag, 1) & cpu.rs_busy.bits;
 }
 
-uint32_t CPU::allocate_rs_entry(const CPU_Core &cpu, InstrType type) {
-    for (uint32_t i = 0; i < RS_SIZE; ++i) {
-        if (!cpu.rs_alu[i].busy) {
-            return i;
-        }
+template <CoreConfig Config>
+bool BasicCPU<Config>::rs_available(const Core &cpu, InstrType type) const {
+    return cpu.rs_busy.first_free(RS_SIZE) < RS_SIZE;
+}
+
+template <CoreConfig Config>
+uint32_t BasicCPU<Config>::allocate_rs_entry(const Core &cpu, InstrType type) {
+    const uint32_t idx = cpu.rs_busy.first_free(RS_SIZE);
+    return idx < RS_SIZE ? idx : 0;
+}
+
+template <CoreConfig Config>
+void BasicCPU<Config>::free_rs_entry(Core &cpu, uint32_t rs_idx, InstrType type) {
+    cpu.rs_busy.reset(rs_idx);
+}
+
+template <CoreConfig Config>
+bool BasicCPU<Config>::LSB_available(const Core &cpu) const {
+    return cpu.lsb_busy.first_free(LSB_SIZE) < LSB_SIZE;
+}
+
+template <CoreConfig Config>
+uint32_t BasicCPU<Config>::allocate_LSB_entry(const Core &cpu) {
+    const uint32_t idx = cpu.lsb_busy.first_free(LSB_SIZE);
+    return idx < LSB_SIZE ? idx : 0;
+}
+
+template <CoreConfig Config>
+void BasicCPU<Config>::free_LSB_entry(Core &cpu, uint32_t LSB_idx) {
+    cpu.lsb_busy.reset(LSB_idx);
+}
+
+template <CoreConfig Config>
+void BasicCPU<Config>::rename_registers(Core &cpu, const ROBEntry &rob_entry, uint32_t rob_idx) {
+    // 物理寄存器堆模式已在译码时重命名
+    if (PHYS_REGS == 0 && rob_entry.dest_reg != 0) {
+        cpu.Regs.set_busy(rob_entry.dest_reg, rob_idx);
     }
-    return 0;
 }
 
-void CPU::free_rs_entry(CPU_Core &cpu, uint32_t rs_idx, InstrType type) {
-    cpu.rs_alu[rs_idx].busy = false;
+template <CoreConfig Config> bool BasicCPU<Config>::writes_register(InstrType type) {
+    // 与分派时调用rename_registers的指令一致；CSR与原子指令在提交时直接写Regs
+    return InstructionProcessor::is_alu_type(type) || InstructionProcessor::is_muldiv_type(type) ||
+           InstructionProcessor::is_load_type(type) || type == InstrType::LUI ||
+           type == InstrType::AUIPC || type == InstrType::JUMP_JAL ||
+           type == InstrType::JUMP_JALR;
 }
 
-bool CPU::LSB_available(const CPU_Core &cpu) const {
-    for (uint32_t i = 0; i < LSB_SIZE; ++i) {
-        if (!cpu.LSB[i].busy) {
-            return true;
+template <CoreConfig Config>
+void BasicCPU<Config>::rename_physical(Core &cpu, ROBEntry &rob_entry, uint32_t source,
+                                       uint32_t constant) {
+    if constexpr (PHYS_REGS != 0) {
+        rob_entry.phys_rs1 = cpu.prf.rename_map[rob_entry.rs1];
+        rob_entry.phys_rs2 = cpu.prf.rename_map[rob_entry.rs2];
+        rob_entry.phys_dest = NO_ROB_TAG;
+        rob_entry.old_phys_dest = NO_ROB_TAG;
+        if (rob_entry.dest_reg == 0 || !writes_register(rob_entry.instr_type)) {
+            return;
         }
+        uint32_t phys;
+        if (rob_entry.idiom == RenameIdiom::Move) {
+            phys = cpu.prf.rename_map[source];
+            ++cpu.prf.refs[phys];
+        } else {
+            phys = cpu.prf.mapped.first_free(PHYS_REGS);
+            cpu.prf.mapped.set(phys);
+            cpu.prf.refs[phys] = 1;
+            if (rob_entry.idiom == RenameIdiom::Constant) {
+                cpu.prf.value[phys] = constant;
+                cpu.prf.ready.set(phys);
+            } else {
+                cpu.prf.ready.reset(phys);
+            }
+        }
+        rob_entry.old_phys_dest = cpu.prf.rename_map[rob_entry.dest_reg];
+        rob_entry.phys_dest = phys;
+        cpu.prf.rename_map[rob_entry.dest_reg] = phys;
     }
-    return false;
 }
 
-uint32_t CPU::allocate_LSB_entry(const CPU_Core &cpu) {
-    for (uint32_t i = 0; i < LSB_SIZE; ++i) {
-        if (!cpu.LSB[i].busy) {
-            return i;
+template <CoreConfig Config>
+void BasicCPU<Config>::retire_physical(Core &cpu, const ROBEntry &rob_entry) {
+    if constexpr (PHYS_REGS != 0) {
+        if (rob_entry.phys_dest == NO_ROB_TAG) {
+            return;
+        }
+        cpu.prf.commit_map[rob_entry.dest_reg] = rob_entry.phys_dest;
+        if (--cpu.prf.refs[rob_entry.old_phys_dest] == 0) {
+            cpu.prf.mapped.reset(rob_entry.old_phys_dest);
         }
     }
-    return 0;
 }
 
-void CPU::free_LSB_entry(CPU_Core &cpu, uint32_t LSB_idx) { cpu.LSB[LSB_idx].busy = false; }
+template <CoreConfig Config>
+uint32_t BasicCPU<Config>::read_source(const Core &cpu, const Core &next_state, uint32_t reg_idx,
+                                       RobTag phys, RobTag &dependency, bool &ready) {
+    if constexpr (PHYS_REGS != 0) {
+        if (reg_idx == 0) {
+            dependency = NO_ROB_TAG;
+            return 0;
+        }
+        if (next_state.prf.ready.test(phys)) {
+            dependency = NO_ROB_TAG;
+            ready = 1;
+            return next_state.prf.value[phys];
+        }
+        dependency = phys;
+        return 0;
+    } else {
+        return read_operand(cpu, reg_idx, dependency, ready);
+    }
+}
 
-void CPU::rename_registers(CPU_Core &cpu, const ROBEntry &rob_entry, uint32_t rob_idx) {
-    if (rob_entry.dest_reg != 0) {
-        cpu.Regs.set_busy(rob_entry.dest_reg, rob_idx);
+template <CoreConfig Config>
+bool BasicCPU<Config>::result_ready(const Core &cpu, RobTag tag, uint32_t &value) const {
+    if constexpr (PHYS_REGS != 0) {
+        if (cpu.prf.ready.test(tag)) {
+            value = cpu.prf.value[tag];
+            return true;
+        }
+    } else if (cpu.rob_state[tag] >= InstrState::Writeback) {
+        value = cpu.rob[tag].value;
+        return true;
     }
+    return false;
 }
 
-uint32_t CPU::read_operand(const CPU_Core &cpu, uint32_t reg_idx, uint32_t &rob_dependency,
-                           bool &ready) {
+template <CoreConfig Config>
+uint32_t BasicCPU<Config>::read_operand(const Core &cpu, uint32_t reg_idx,
+                                        RobTag &rob_dependency, bool &ready) {
     if (reg_idx == 0) {
-        rob_dependency = ROB_SIZE;
+        rob_dependency = NO_ROB_TAG;
         return 0;
     }
 
     if (cpu.Regs.is_busy(reg_idx)) {
         uint32_t rob_idx = cpu.Regs.get_rob_index(reg_idx);
-        if (cpu.rob[rob_idx].state >= InstrState::Writeback) {
-            rob_dependency = ROB_SIZE;
+        if (cpu.rob_state[rob_idx] >= InstrState::Writeback) {
+            rob_dependency = NO_ROB_TAG;
             ready = 1;
             return cpu.rob[rob_idx].value;
         } else {
@@ -683,157 +1360,157 @@ uint32_t CPU::read_operand(const CPU_Core &cpu, uint32_t reg_idx, uint32_t &rob_
             return 0;
         }
     } else {
-        rob_dependency = ROB_SIZE;
+        rob_dependency = NO_ROB_TAG;
         ready = 1;
         return cpu.Regs.get_value(reg_idx);
     }
 }
 
-void CPU::broadcast_result(const CPU_Core &now_state, CPU_Core &next_state, uint32_t rob_idx,
-                           uint32_t value) {
-    next_state.rob[rob_idx].state = InstrState::Commit;
-    for (uint32_t i = 0; i < RS_SIZE; ++i) {
-        RSEntry &rs = next_state.rs_alu[i];
-        const RSEntry rs_now = now_state.rs_alu[i];
-        if (rs_now.busy) {
-            if (rs_now.Qj == rob_idx) {
-                rs.Vj = value;
-                rs.Qj = ROB_SIZE;
-            }
-            if (rs_now.Qk == rob_idx) {
-                rs.Vk = value;
-                rs.Qk = ROB_SIZE;
-            }
-        }
+template <CoreConfig Config>
+void BasicCPU<Config>::broadcast_results(const Core &now_state, Core &next_state, const CDB &cdb) {
+    // 每个标签数组与CDB上的全部标签比较一次得到匹配位图，再只处理匹配的条目；
+    // 一个条目的依赖至多匹配一个结果，值按标签取出
+    const uint64_t rs_busy = now_state.rs_busy.bits;
+    for (uint64_t match = match_tags<RS_SIZE>(now_state.rs_qj, cdb.tag, cdb.count) & rs_busy;
+         match; match &= match - 1) {
+        const uint32_t i = std::countr_zero(match);
+        next_state.rs_alu[i].Vj = cdb.value[now_state.rs_qj[i]];
+        next_state.rs_qj[i] = NO_ROB_TAG;
     }
-
-    for (uint32_t i = 0; i < LSB_SIZE; ++i) {
-        LSBEntry &LSB = next_state.LSB[i];
-        const LSBEntry LSB_now = now_state.LSB[i];
-        if (LSB.busy && LSB.base_rob_idx == rob_idx) {
-
-            LSB.base_value = value;
-            LSB.base_rob_idx = ROB_SIZE;
-            LSB.address_ready = true;
-            LSB.address = value + LSB_now.offset;
-            //  cout << "ADDR:" << Type_string(LSB.op) << " " << LSB.address << " " << value << " "
-            //       << LSB_now.offset << std::endl;
-        }
-        if (LSB.busy && LSB.value_rob_idx == rob_idx) {
-            LSB.value = value;
-            LSB.value_rob_idx = ROB_SIZE;
-        }
+    for (uint64_t match = match_tags<RS_SIZE>(now_state.rs_qk, cdb.tag, cdb.count) & rs_busy;
+         match; match &= match - 1) {
+        const uint32_t i = std::countr_zero(match);
+        next_state.rs_alu[i].Vk = cdb.value[now_state.rs_qk[i]];
+        next_state.rs_qk[i] = NO_ROB_TAG;
     }
-}
 
-bool CPU::is_earlier_instruction(const CPU_Core &cpu, uint32_t rob_idx1, uint32_t rob_idx2) {
-
-    uint32_t pos1, pos2;
-
-    if (rob_idx1 >= cpu.rob_head) {
-        pos1 = rob_idx1 - cpu.rob_head;
-    } else {
-        pos1 = (ROB_SIZE - cpu.rob_head) + rob_idx1;
+    const uint64_t lsb_busy = next_state.lsb_busy.bits;
+    for (uint64_t match = match_tags<LSB_SIZE>(next_state.lsb_base_tag, cdb.tag, cdb.count) &
+                          lsb_busy;
+         match; match &= match - 1) {
+        const uint32_t i = std::countr_zero(match);
+        const uint32_t value = cdb.value[next_state.lsb_base_tag[i]];
+        LSBEntry &LSB = next_state.LSB[i];
+        LSB.base_value = value;
+        LSB.address_ready = true;
+        LSB.address = value + now_state.LSB[i].offset;
+        next_state.lsb_base_tag[i] = NO_ROB_TAG;
     }
-
-    if (rob_idx2 >= cpu.rob_head) {
-        pos2 = rob_idx2 - cpu.rob_head;
-    } else {
-        pos2 = (ROB_SIZE - cpu.rob_head) + rob_idx2;
+    for (uint64_t match = match_tags<LSB_SIZE>(next_state.lsb_value_tag, cdb.tag, cdb.count) &
+                          lsb_busy;
+         match; match &= match - 1) {
+        const uint32_t i = std::countr_zero(match);
+        next_state.LSB[i].value = cdb.value[next_state.lsb_value_tag[i]];
+        next_state.lsb_value_tag[i] = NO_ROB_TAG;
     }
+}
 
-    return pos1 < pos2;
+template <CoreConfig Config>
+bool BasicCPU<Config>::is_earlier_instruction(const Core &cpu, uint32_t rob_idx1,
+                                              uint32_t rob_idx2) {
+    return ring_offset<ROB_SIZE>(rob_idx1, cpu.rob_head) <
+           ring_offset<ROB_SIZE>(rob_idx2, cpu.rob_head);
 }
 
-bool CPU::check_load_dependencies(const CPU_Core &cpu, uint32_t load_addr, uint32_t load_rob_idx,
-                                  uint32_t &forwarded_value) {
-    for (uint32_t i = 0; i < LSB_SIZE; ++i) {
+template <CoreConfig Config>
+uint32_t BasicCPU<Config>::find_older_store(const Core &cpu, const LSBEntry &load, bool &unknown) {
+    const uint64_t load_begin = load.address;
+    const uint64_t load_end = load_begin + InstructionProcessor::get_access_size(load.op);
+    uint32_t youngest = LSB_SIZE;
+    unknown = false;
+
+    for (uint64_t busy = cpu.lsb_busy.bits; busy; busy &= busy - 1) {
+        const uint32_t i = std::countr_zero(busy);
         const LSBEntry &LSB = cpu.LSB[i];
 
-        if (!LSB.busy || !InstructionProcessor::is_store_type(LSB.op)) {
+        if (!InstructionProcessor::is_store_type(LSB.op)) {
             continue;
         }
 
-        if (!is_earlier_instruction(cpu, LSB.rob_idx, load_rob_idx)) {
+        if (!is_earlier_instruction(cpu, LSB.rob_idx, load.rob_idx)) {
             continue;
         }
 
         if (!LSB.address_ready) {
-            return false;
+            unknown = true;
+            continue;
         }
 
-        if (LSB.address == load_addr) {
-            if (LSB.value_rob_idx == ROB_SIZE && LSB.execute_completed) {
-                return true;
-            } else {
-                return false;
+        const uint64_t store_begin = LSB.address;
+        const uint64_t store_end = store_begin + InstructionProcessor::get_access_size(LSB.op);
+        if (store_begin < load_end && load_begin < store_end) {
+            if (youngest == LSB_SIZE ||
+                is_earlier_instruction(cpu, cpu.LSB[youngest].rob_idx, LSB.rob_idx)) {
+                youngest = i;
             }
         }
     }
-
-    return true;
+    return youngest;
 }
 
-bool CPU::get_load_values(const CPU_Core &cpu, uint32_t load_addr, uint32_t load_rob_idx,
-                          uint32_t &forwarded_value) {
-
-    for (uint32_t i = 0; i < LSB_SIZE; ++i) {
-        const LSBEntry &LSB = cpu.LSB[i];
-
-        if (!LSB.busy || !InstructionProcessor::is_store_type(LSB.op)) {
-            continue;
-        }
-
-        if (!is_earlier_instruction(cpu, LSB.rob_idx, load_rob_idx)) {
-            continue;
-        }
-
-        if (!LSB.address_ready) {
-            return false;
-        }
+template <CoreConfig Config>
+bool BasicCPU<Config>::check_load_dependencies(const Core &cpu, const LSBEntry &load) {
+    bool unknown;
+    return find_older_store(cpu, load, unknown) == LSB_SIZE && !unknown;
+}
 
-        if (LSB.address == load_addr) {
-            if (LSB.value_rob_idx == ROB_SIZE && LSB.execute_completed) {
-                forwarded_value = LSB.value;
-                return true;
-            } else {
-                return false;
-            }
-        }
+template <CoreConfig Config>
+bool BasicCPU<Config>::get_load_values(const Core &cpu, const LSBEntry &load,
+                                       uint32_t &forwarded_value) {
+    bool unknown;
+    const uint32_t idx = find_older_store(cpu, load, unknown);
+    if (unknown || idx == LSB_SIZE) {
+        return false;
     }
 
-    return false;
+    // 只有Store完整覆盖Load的字节时才能转发，部分重叠需等Store写入内存
+    const LSBEntry &store = cpu.LSB[idx];
+    const uint32_t offset = load.address - store.address;
+    if (load.address < store.address ||
+        offset + InstructionProcessor::get_access_size(load.op) >
+            InstructionProcessor::get_access_size(store.op)) {
+        return false;
+    }
+    if (cpu.lsb_value_tag[idx] != NO_ROB_TAG || !store.execute_completed) {
+        return false;
+    }
+    forwarded_value = InstructionProcessor::extend_load(load.op, store.value >> (offset * 8));
+    return true;
 }
 
-bool CPU::predict_branch_taken(const CPU_Core &cpu) { return false; }
+template <CoreConfig Config>
+bool BasicCPU<Config>::predict_branch_taken(const Core &cpu) { return false; }
 
-void CPU::handle_branch_misprediction(CPU_Core &cpu, uint32_t correct_pc) {
+template <CoreConfig Config>
+void BasicCPU<Config>::handle_branch_misprediction(Core &cpu, uint32_t correct_pc) {
     // print(cpu);
+    // 只在提交阶段调用，冲刷前ROB头部的指令已经提交
+    ++instruction_count_;
     ++branch_mispredictions_;
     cpu.next_pc = correct_pc;
     flush_pipeline(cpu);
 }
 
-void CPU::flush_pipeline(CPU_Core &cpu) {
+template <CoreConfig Config>
+void BasicCPU<Config>::serialize_pipeline(Core &cpu, uint32_t next_pc) {
+    ++instruction_count_;
+    cpu.next_pc = next_pc;
+    flush_pipeline(cpu);
+}
+
+template <CoreConfig Config>
+void BasicCPU<Config>::flush_pipeline(Core &cpu) {
     // cout << "CLEAR\n";
-    for (int i = 0; i < FETCH_BUFFER_SIZE; ++i) {
+    for (uint32_t i = 0; i < FETCH_BUFFER_SIZE; ++i) {
         cpu.fetch_buffer[i].valid = false;
     }
     cpu.fetch_buffer_head = 0;
     cpu.fetch_buffer_tail = 0;
     cpu.fetch_buffer_size = 0;
 
-    for (uint32_t i = 0; i < RS_SIZE; ++i) {
-        cpu.rs_alu[i].busy = false;
-    }
-
-    for (uint32_t i = 0; i < LSB_SIZE; ++i) {
-        cpu.LSB[i].busy = false;
-    }
-
-    for (uint32_t i = 0; i < ROB_SIZE; ++i) {
-        cpu.rob[i].busy = false;
-    }
+    cpu.rs_busy = BusyBits();
+    cpu.lsb_busy = BusyBits();
+    cpu.rob_busy = BusyBits();
     cpu.rob_head = 0;
     cpu.rob_tail = 0;
     cpu.rob_size = 0;
@@ -841,6 +1518,13 @@ void CPU::flush_pipeline(CPU_Core &cpu) {
     cpu.clear_flag = 1;
 
     cpu.Regs.flush();
+    cpu.restore_rename_map();
 
+    cpu.fetch_blocked = false;
     cpu.pipeline_flushed = true;
 }
+
+template class BasicCPU<BASE_CORE>;
+template class BasicCPU<MEDIUM_CORE>;
+template class BasicCPU<LARGE_CORE>;
+template class BasicCPU<PRF_CORE>;
@@ -0,0 +1,157 @@
+#include "../include/profiler.h"
+
+#include "../include/instruction.h"
+
+#include <algorithm>
+#include <iomanip>
+
+HotspotProfiler::HotspotProfiler(uint32_t text_begin, uint32_t text_end)
+    : mask_(0), used_(0), total_cycles_(0), flush_cycles_(0), empty_cycles_(0) {
+    // 容量取指令条数的两倍并向上取整到2的幂，保证装载因子不超过一半
+    uint32_t instructions = text_end > text_begin ? (text_end - text_begin) / 4 : 0;
+    uint32_t capacity = 64;
+    while (capacity < instructions * 2) {
+        capacity <<= 1;
+    }
+    table_.resize(capacity);
+    mask_ = capacity - 1;
+
+    for (uint32_t i = 0; i < MAX_ROB_SIZE; ++i) {
+        load_start_[i] = 0;
+        load_latency_[i] = 0;
+    }
+}
+
+HotspotProfiler::Entry &HotspotProfiler::lookup(uint32_t pc) {
+    uint32_t idx = ((pc >> 1) * 0x9E3779B1u) & mask_;
+    while (table_[idx].used && table_[idx].pc != pc) {
+        idx = (idx + 1) & mask_;
+    }
+    if (!table_[idx].used) {
+        if ((used_ + 1) * 4 > table_.size() * 3) {
+            grow();
+            return lookup(pc);
+        }
+        table_[idx].used = true;
+        table_[idx].pc = pc;
+        ++used_;
+    }
+    return table_[idx];
+}
+
+void HotspotProfiler::grow() {
+    std::vector<Entry> old;
+    old.swap(table_);
+    table_.resize(old.size() * 2);
+    mask_ = table_.size() - 1;
+    used_ = 0;
+    for (const Entry &entry : old) {
+        if (entry.used) {
+            lookup(entry.pc) = entry;
+        }
+    }
+}
+
+template <CoreConfig Config>
+void HotspotProfiler::skip(const BasicCore<Config> &state, uint64_t cycles) {
+    total_cycles_ += cycles;
+    lookup(state.rob[state.rob_head].pc).stall_cycles += cycles;
+}
+
+template <CoreConfig Config>
+void HotspotProfiler::sample(const BasicCore<Config> &now_state,
+                             const BasicCore<Config> &next_state, uint64_t cycle,
+                             bool mispredicted) {
+    ++total_cycles_;
+
+    if (now_state.clear_flag) {
+        ++flush_cycles_;
+        return;
+    }
+
+    // 通过ROB状态的变化得到Load的分派与完成时刻
+    for (uint32_t i = 0; i < Config.rob_size; ++i) {
+        if (!now_state.rob_busy.test(i) ||
+            !InstructionProcessor::is_load_type(now_state.rob[i].instr_type)) {
+            continue;
+        }
+        const InstrState now = now_state.rob_state[i];
+        const InstrState next = next_state.rob_state[i];
+        if (now == InstrState::Dispatch && next == InstrState::Execute) {
+            load_start_[i] = cycle;
+        } else if (now == InstrState::Execute && next == InstrState::Writeback) {
+            load_latency_[i] = cycle - load_start_[i] + 1;
+        }
+    }
+
+    const ROBEntry &head = now_state.rob[now_state.rob_head];
+    if (!now_state.rob_busy.test(now_state.rob_head)) {
+        ++empty_cycles_;
+        return;
+    }
+
+    Entry &entry = lookup(head.pc);
+    if (next_state.commit_flag || next_state.clear_flag) {
+        ++entry.commits;
+        if (mispredicted) {
+            ++entry.mispredictions;
+        } else if (next_state.clear_flag) {
+            ++entry.flushes;
+        }
+        if (InstructionProcessor::is_load_type(head.instr_type)) {
+            ++entry.loads;
+            entry.load_cycles += load_latency_[now_state.rob_head];
+        }
+    } else {
+        ++entry.stall_cycles;
+    }
+}
+
+template void HotspotProfiler::sample(const CPU_Core &, const CPU_Core &, uint64_t, bool);
+template void HotspotProfiler::sample(const BasicCore<MEDIUM_CORE> &,
+                                      const BasicCore<MEDIUM_CORE> &, uint64_t, bool);
+template void HotspotProfiler::sample(const BasicCore<LARGE_CORE> &,
+                                      const BasicCore<LARGE_CORE> &, uint64_t, bool);
+template void HotspotProfiler::sample(const BasicCore<PRF_CORE> &, const BasicCore<PRF_CORE> &,
+                                      uint64_t, bool);
+template void HotspotProfiler::skip(const CPU_Core &, uint64_t);
+template void HotspotProfiler::skip(const BasicCore<MEDIUM_CORE> &, uint64_t);
+template void HotspotProfiler::skip(const BasicCore<LARGE_CORE> &, uint64_t);
+template void HotspotProfiler::skip(const BasicCore<PRF_CORE> &, uint64_t);
+
+void HotspotProfiler::write_report(std::ostream &out, const uint8_t memory[]) const {
+    std::vector<const Entry *> entries;
+    for (const Entry &entry : table_) {
+        if (entry.used) {
+            entries.push_back(&entry);
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry *a, const Entry *b) {
+        if (a->stall_cycles != b->stall_cycles) {
+            return a->stall_cycles > b->stall_cycles;
+        }
+        if (a->mispredictions != b->mispredictions) {
+            return a->mispredictions > b->mispredictions;
+        }
+        return a->pc < b->pc;
+    });
+
+    out << "# cycles " << total_cycles_ << ", flush " << flush_cycles_ << ", rob empty "
+        << empty_cycles_ << "\n";
+    out << std::setw(8) << "pc" << std::setw(11) << "stall" << std::setw(11) << "commits"
+        << std::setw(9) << "mispred" << std::setw(9) << "flush" << std::setw(9) << "loads" << std::setw(9) << "avg_lat"
+        << "  instruction\n";
+    for (const Entry *entry : entries) {
+        uint32_t raw = 0;
+        InstructionProcessor::fetch(memory, entry->pc, raw);
+        Instruction instr = InstructionProcessor::decode(raw, entry->pc);
+        double avg_latency =
+            entry->loads ? static_cast<double>(entry->load_cycles) / entry->loads : 0.0;
+
+        out << std::hex << std::setw(8) << std::setfill('0') << entry->pc << std::dec
+            << std::setfill(' ') << std::setw(11) << entry->stall_cycles << std::setw(11)
+            << entry->commits << std::setw(9) << entry->mispredictions << std::setw(9)
+            << entry->flushes << std::setw(9) << entry->loads << std::setw(9) << std::fixed << std::setprecision(2) << avg_latency
+            << "  " << InstructionProcessor::disassemble(instr) << "\n";
+    }
+}
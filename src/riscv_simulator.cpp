@@ -1,14 +1,32 @@
 #include "../include/riscv_simulator.h"
 
+#include "../include/checkpoint.h"
+#include "../include/coherence.h"
+#include "../include/csr.h"
+#include "../include/devices.h"
+#include "../include/functional_core.h"
 #include "../include/instruction.h"
 #include "../include/process.h"
 
+#include <algorithm>
+#include <barrier>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <string>
+#include <thread>
 
 extern int cnt;
 
-RISCV_Simulator::RISCV_Simulator() : is_halted(false) { cpu_core = new CPU(); }
+RISCV_Simulator::RISCV_Simulator(const SimConfig &config)
+    : is_halted(false), deadlocked(false), checker(nullptr), config(config), image_begin(MEMORY_SIZE),
+      image_end(0), program_break(0), syscalls(nullptr), bus(nullptr), events(nullptr),
+      global_time(0) {
+    cpu_core = new CPU();
+}
 
 RISCV_Simulator::~RISCV_Simulator() { delete cpu_core; }
 
@@ -25,34 +43,544 @@ void RISCV_Simulator::load_program() {
             unsigned int byte_value;
             std::cin >> std::hex >> byte_value;
             if (current_address < MEMORY_SIZE) {
+                image_begin = std::min(image_begin, current_address);
+                image_end = std::max(image_end, current_address + 1);
                 cpu.memory[current_address++] = static_cast<uint8_t>(byte_value);
             }
         }
     }
+    program_break = (image_end + 15) & ~15u;
 }
 
-void RISCV_Simulator::run() {
+bool RISCV_Simulator::restore_checkpoint(const std::string &path) {
+    CPU_Stats stats = cpu_core->get_stats();
+    if (!load_checkpoint(path, cpu, stats, program_break, clint_state)) {
+        return false;
+    }
+    cpu_core->set_stats(stats);
+    return true;
+}
+
+int RISCV_Simulator::run() {
+    std::ifstream input_file;
+    if (!config.input_path.empty()) {
+        input_file.open(config.input_path, std::ios::binary);
+        if (!input_file) {
+            std::cerr << "Error: cannot open " << config.input_path << std::endl;
+        }
+    }
+    SyscallHandler syscall_handler(config.input_path.empty() ? std::cin : input_file,
+                                   program_break);
+    syscalls = &syscall_handler;
+    cpu_core->set_syscall_handler(syscalls);
+
+    Bus device_bus;
+    EventQueue event_queue;
+    Uart uart(syscall_handler);
+    Clint clint(device_bus, event_queue, [this]() {
+        return config.harts > 1 || config.core != CoreKind::Base ? global_time.load()
+                                                                  : cpu_core->get_cycle_count();
+    });
+    ToHost tohost(device_bus);
+    clint.set_state(clint_state);
+    device_bus.attach(CLINT_BASE, CLINT_SIZE, &clint);
+    device_bus.attach(UART_BASE, UART_SIZE, &uart);
+    device_bus.attach(TOHOST_BASE, TOHOST_SIZE, &tohost);
+    bus = &device_bus;
+    events = &event_queue;
+    cpu_core->set_bus(bus);
+    cpu_core->set_misaligned_policy(config.misaligned);
+    cpu_core->set_macro_fusion(config.fusion);
+
+    HotspotProfiler *profiler = nullptr;
+    if (!config.profile_path.empty()) {
+        profiler = new HotspotProfiler(image_begin, image_end);
+        cpu_core->set_profiler(profiler);
+    }
+
+    if (config.harts > 1) {
+        run_multihart();
+    } else if (!config.bbv_path.empty()) {
+        run_bbv();
+    } else if (config.sample_interval) {
+        run_sampled();
+    } else if (config.cosim) {
+        checker = new CosimChecker(cpu);
+        checker->set_misaligned_policy(config.misaligned);
+        checker->set_address_map(bus);
+        cpu_core->set_checker(checker);
+    }
+    if (config.core == CoreKind::Medium) {
+        run_core<MEDIUM_CORE>(profiler);
+    } else if (config.core == CoreKind::Large) {
+        run_core<LARGE_CORE>(profiler);
+    } else if (config.core == CoreKind::Prf) {
+        run_core<PRF_CORE>(profiler);
+    }
 
     while (!is_halted) {
         tick();
+
+        if (!config.checkpoint_path.empty()) {
+            uint64_t cycle = cpu_core->get_cycle_count();
+            if (config.checkpoint_interval && cycle % config.checkpoint_interval == 0) {
+                save_checkpoint(config.checkpoint_path, cpu, cpu_core->get_stats(),
+                                syscalls->get_program_break(), clint.get_state());
+            }
+            if (cycle == config.checkpoint_at) {
+                if (save_checkpoint(config.checkpoint_path, cpu, cpu_core->get_stats(),
+                                    syscalls->get_program_break(), clint.get_state())) {
+                    std::cerr << "Checkpoint saved at cycle " << cycle << std::endl;
+                }
+                break;
+            }
+        }
+    }
+    if (cpu_core->get_exception().cause != ExceptionCause::None) {
+        exception = cpu_core->get_exception();
+    }
+
+    int status = SIM_EXIT_OK;
+    if (exception.cause != ExceptionCause::None) {
+        syscall_handler.flush();
+        report_exception();
+        status = SIM_EXIT_EXCEPTION;
+    } else if (deadlocked) {
+        status = SIM_EXIT_DEADLOCK;
+    }
+    if (checker) {
+        if (!checker->has_failed()) {
+            checker->finish(cpu, cpu_core->get_cycle_count());
+        }
+        if (checker->has_failed()) {
+            status = SIM_EXIT_COSIM_MISMATCH;
+        } else {
+            std::cerr << "Cosim: " << checker->get_checked_count() << " commits matched"
+                      << std::endl;
+        }
+        cpu_core->set_checker(nullptr);
+        delete checker;
+        checker = nullptr;
+    }
+
+    syscall_handler.flush();
+    cpu_core->set_syscall_handler(nullptr);
+    syscalls = nullptr;
+    if (device_bus.has_exited() && device_bus.get_exit_code() != 0) {
+        std::cerr << "tohost: exit code " << device_bus.get_exit_code() << std::endl;
+    }
+    cpu_core->set_bus(nullptr);
+    bus = nullptr;
+    events = nullptr;
+
+    if (is_halted && status == SIM_EXIT_OK) {
+        print_result();
+    }
+    if (config.stats) {
+        if (config.core == CoreKind::Base) {
+            print_core_stats(*cpu_core);
+        }
+        print_stats();
+    }
+#ifdef SIM_STAGE_TIMERS
+    if (config.harts == 1 && config.core == CoreKind::Base) {
+        cpu_core->get_stage_timers().report(std::cerr, cpu_core->get_cycle_count());
+    }
+#endif
+
+    if (profiler) {
+        std::ofstream out(config.profile_path);
+        if (out) {
+            profiler->write_report(out, cpu.memory);
+        } else {
+            std::cerr << "Error: cannot write profile to " << config.profile_path << std::endl;
+        }
+        cpu_core->set_profiler(nullptr);
+        delete profiler;
     }
-    print_result();
+    return status;
+}
+
+void RISCV_Simulator::run_multihart() {
+    // 0号hart使用cpu_core与cpu.core，其余hart从相同的初始状态开始，只有mhartid不同
+    CoherenceDirectory coherence;
+    std::vector<std::unique_ptr<CPU>> extra_cpus;
+    std::vector<std::unique_ptr<CPU_Core>> extra_cores;
+    std::vector<CPU *> cpus = {cpu_core};
+    std::vector<CPU_Core *> cores = {&cpu.core};
+    for (uint32_t hart = 1; hart < config.harts; ++hart) {
+        extra_cpus.push_back(std::make_unique<CPU>());
+        extra_cores.push_back(std::make_unique<CPU_Core>(cpu.core));
+        cpus.push_back(extra_cpus.back().get());
+        cores.push_back(extra_cores.back().get());
+    }
+    for (uint32_t hart = 0; hart < config.harts; ++hart) {
+        cores[hart]->csr.mhartid = hart;
+        cpus[hart]->set_syscall_handler(syscalls);
+        cpus[hart]->set_bus(bus);
+        cpus[hart]->set_misaligned_policy(config.misaligned);
+        cpus[hart]->set_macro_fusion(config.fusion);
+        cpus[hart]->set_coherence(&coherence);
+    }
+
+    // 屏障的完成函数在所有hart都停在屏障时执行，可以安全地推进时间、触发设备事件
+    std::atomic<bool> stop(false);
+    std::barrier sync(config.harts, [&]() noexcept {
+        global_time += config.quantum;
+        events->run_until(global_time);
+        bool running = false;
+        for (uint32_t hart = 0; hart < config.harts; ++hart) {
+            if (cpus[hart]->get_exception().cause != ExceptionCause::None) {
+                stop = true;
+            }
+            running = running || !cores[hart]->fetch_stalled;
+        }
+        if (!running || syscalls->has_exited() || bus->has_exited()) {
+            stop = true;
+        }
+    });
+
+    auto run_hart = [&](uint32_t hart) {
+        CPU &core_model = *cpus[hart];
+        CPU_Core &core = *cores[hart];
+        while (!stop) {
+            const uint64_t quantum_end = global_time + config.quantum;
+            while (core_model.get_cycle_count() < quantum_end && !core.fetch_stalled) {
+                core_model.tick(core, cpu.memory);
+                if (core_model.is_waiting()) {
+                    // 中断只在屏障处到来，本quantum余下的周期都是空闲的
+                    core_model.skip_cycles(core, quantum_end - core_model.get_cycle_count());
+                }
+            }
+            sync.arrive_and_wait();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t hart = 1; hart < config.harts; ++hart) {
+        threads.emplace_back(run_hart, hart);
+    }
+    run_hart(0);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    for (uint32_t hart = 0; hart < config.harts; ++hart) {
+        if (exception.cause == ExceptionCause::None &&
+            cpus[hart]->get_exception().cause != ExceptionCause::None) {
+            exception = cpus[hart]->get_exception();
+        }
+        std::cerr << "Hart " << hart << ": " << cpus[hart]->get_cycle_count() << " cycles, "
+                  << cpus[hart]->get_instruction_count() << " instructions" << std::endl;
+    }
+    std::cerr << "Coherence: " << coherence.get_invalidations() << " invalidations, "
+              << coherence.get_interventions() << " interventions" << std::endl;
+#ifdef SIM_STAGE_TIMERS
+    // 各hart的时间相加，总和可以超过实际经过的时间
+    StageTimers timers = cpus[0]->get_stage_timers();
+    uint64_t cycles = cpus[0]->get_cycle_count();
+    for (uint32_t hart = 1; hart < config.harts; ++hart) {
+        timers.merge(cpus[hart]->get_stage_timers());
+        cycles += cpus[hart]->get_cycle_count();
+    }
+    timers.report(std::cerr, cycles);
+#endif
+    cpu_core->set_coherence(nullptr);
+    is_halted = true;
+}
+
+template <CoreConfig Config> void RISCV_Simulator::run_core(HotspotProfiler *profiler) {
+    // 从cpu.core的架构状态开始，结束后把架构状态写回cpu.core、统计信息记到cpu_core上，
+    // 之后的结果输出与默认配置相同
+    auto model = std::make_unique<BasicCPU<Config>>();
+    auto core = std::make_unique<BasicCore<Config>>();
+    BasicCPU<Config>::load_architectural_state(*core, cpu.core);
+    model->set_syscall_handler(syscalls);
+    model->set_bus(bus);
+    model->set_misaligned_policy(config.misaligned);
+    model->set_macro_fusion(config.fusion);
+    model->set_profiler(profiler);
+    model->set_checker(checker);
+
+    while (!is_halted) {
+        global_time.store(model->get_cycle_count(), std::memory_order_relaxed);
+        events->run_until(model->get_cycle_count());
+        model->tick(*core, cpu.memory);
+        if (model->is_waiting()) {
+            const uint64_t cycle = model->get_cycle_count();
+            const uint64_t target = idle_target(cycle);
+            if (target > cycle) {
+                model->skip_cycles(*core, target - cycle);
+            }
+        }
+        if ((checker && checker->has_failed()) || core->fetch_stalled) {
+            is_halted = true;
+        }
+    }
+
+    exception = model->get_exception();
+    if (config.stats) {
+        print_core_stats(*model);
+    }
+    CPU::load_architectural_state(cpu.core, *core);
+    cpu_core->set_stats(model->get_stats());
+#ifdef SIM_STAGE_TIMERS
+    model->get_stage_timers().report(std::cerr, model->get_cycle_count());
+#endif
+}
+
+uint64_t RISCV_Simulator::run_detailed(uint64_t count) {
+    const uint64_t start_cycle = cpu_core->get_cycle_count();
+    const uint64_t start_instruction = cpu_core->get_instruction_count();
+    while (!is_halted && cpu_core->get_instruction_count() - start_instruction < count) {
+        tick();
+    }
+    return cpu_core->get_cycle_count() - start_cycle;
+}
+
+bool RISCV_Simulator::read_simpoints(std::vector<std::pair<uint64_t, double>> &points) {
+    std::ifstream point_file(config.simpoint_path);
+    if (!point_file) {
+        std::cerr << "Error: cannot open " << config.simpoint_path << std::endl;
+        return false;
+    }
+    std::map<uint64_t, double> weights; // 类号 -> 权重
+    if (!config.simpoint_weight_path.empty()) {
+        std::ifstream weight_file(config.simpoint_weight_path);
+        if (!weight_file) {
+            std::cerr << "Error: cannot open " << config.simpoint_weight_path << std::endl;
+            return false;
+        }
+        double weight;
+        uint64_t cluster;
+        while (weight_file >> weight >> cluster) {
+            weights[cluster] = weight;
+        }
+    }
+
+    uint64_t interval, cluster;
+    while (point_file >> interval >> cluster) {
+        double weight = 1.0;
+        if (!weights.empty()) {
+            auto it = weights.find(cluster);
+            weight = it == weights.end() ? 0.0 : it->second;
+        }
+        points.emplace_back(interval, weight);
+    }
+    std::sort(points.begin(), points.end());
+    return true;
+}
+
+void RISCV_Simulator::run_sampled() {
+    FunctionalCore functional;
+    functional.set_syscall_handler(syscalls);
+    functional.set_bus(bus);
+    functional.set_misaligned_policy(config.misaligned);
+    std::vector<SampleWindow> windows;
+    const uint64_t detailed_start = cpu_core->get_instruction_count();
+
+    // 已执行的总指令数（功能模型+乱序模型提交）
+    auto executed = [&]() {
+        return functional.get_instruction_count() + cpu_core->get_instruction_count() -
+               detailed_start;
+    };
+    // 功能模型快进到第target条指令
+    auto fast_forward = [&](uint64_t target) {
+        if (target > executed()) {
+            functional.run(cpu, target - executed());
+        }
+        if (functional.is_halted()) {
+            is_halted = true;
+            exception = functional.get_exception();
+        }
+    };
+    // 两个模型各自的计数器，切换时据此调整CSR计数器的偏移
+    auto functional_counters = [&]() {
+        CSRCounters counters;
+        counters.cycle = functional.get_instruction_count();
+        counters.instret = functional.get_instruction_count();
+        return counters;
+    };
+    auto detailed_counters = [&]() {
+        CSRCounters counters;
+        counters.cycle = cpu_core->get_cycle_count();
+        counters.instret = cpu_core->get_instruction_count();
+        return counters;
+    };
+    // 在乱序模型上预热warmup条、测量window条指令，然后切回功能模型
+    auto measure = [&](uint64_t warmup, uint64_t window, double weight) {
+        CSRProcessor::rebase(cpu.core.csr, functional_counters(), detailed_counters());
+        run_detailed(warmup);
+        SampleWindow sample;
+        uint64_t before = cpu_core->get_instruction_count();
+        sample.cycles = run_detailed(window);
+        sample.instructions = cpu_core->get_instruction_count() - before;
+        sample.weight = weight;
+        if (sample.instructions > 0) {
+            windows.push_back(sample);
+        }
+        if (!is_halted) {
+            CSRProcessor::rebase(cpu.core.csr, detailed_counters(), functional_counters());
+            CPU::flush_to_architectural_state(cpu.core);
+        }
+    };
+
+    // 从功能模型开始执行；从检查点恢复时乱序模型停在流水线中间，先回到架构状态
+    CSRProcessor::rebase(cpu.core.csr, detailed_counters(), functional_counters());
+    CPU::flush_to_architectural_state(cpu.core);
+
+    if (!config.simpoint_path.empty()) {
+        std::vector<std::pair<uint64_t, double>> points;
+        if (!read_simpoints(points)) {
+            return;
+        }
+        for (const auto &point : points) {
+            uint64_t start = point.first * config.sample_interval;
+            uint64_t warm_start = start > config.sample_warmup ? start - config.sample_warmup : 0;
+            if (executed() > warm_start) {
+                continue; // 与上一个区间重叠
+            }
+            fast_forward(warm_start);
+            if (is_halted) {
+                break;
+            }
+            measure(start - warm_start, config.sample_interval, point.second);
+            if (is_halted) {
+                break;
+            }
+        }
+    } else {
+        const uint64_t detailed = config.sample_warmup + config.sample_window;
+        const uint64_t skip = config.sample_interval > detailed ? config.sample_interval - detailed
+                                                                : 0;
+        while (!is_halted) {
+            fast_forward(executed() + skip);
+            if (is_halted) {
+                break;
+            }
+            measure(config.sample_warmup, config.sample_window, 1.0);
+        }
+    }
+
+    // 剩余部分由功能模型执行完，用于得到总指令数和最终结果
+    while (!is_halted) {
+        fast_forward(executed() + config.sample_interval);
+    }
+    report_samples(windows, executed());
+}
+
+void RISCV_Simulator::run_bbv() {
+    std::ofstream out(config.bbv_path);
+    if (!out) {
+        std::cerr << "Error: cannot write " << config.bbv_path << std::endl;
+        return;
+    }
+    BBVProfiler bbv(out, config.bbv_interval);
+    FunctionalCore functional;
+    functional.set_syscall_handler(syscalls);
+    functional.set_bus(bus);
+    functional.set_misaligned_policy(config.misaligned);
+    functional.set_bbv_profiler(&bbv);
+    // 从检查点恢复时丢弃流水线中未提交的指令，从下一条待提交的指令开始统计
+    CPU::flush_to_architectural_state(cpu.core);
+    while (functional.step(cpu)) {
+    }
+    bbv.finish();
+    is_halted = true;
+    exception = functional.get_exception();
+    std::cerr << "BBV: " << bbv.get_interval_count() << " intervals of " << config.bbv_interval
+              << " instructions, " << functional.get_instruction_count() << " instructions total"
+              << std::endl;
+}
+
+void RISCV_Simulator::report_samples(const std::vector<SampleWindow> &windows,
+                                     uint64_t total_instructions) {
+    uint64_t detailed = 0;
+    double weight_sum = 0, mean = 0;
+    for (const SampleWindow &window : windows) {
+        detailed += window.instructions;
+        weight_sum += window.weight;
+        mean += window.weight * window.cycles / window.instructions;
+    }
+    std::cerr << "Sampled simulation: " << windows.size() << " windows, " << detailed << " of "
+              << total_instructions << " instructions simulated in detail" << std::endl;
+    if (windows.empty() || weight_sum <= 0) {
+        return;
+    }
+    mean /= weight_sum;
+
+    std::cerr << std::fixed << std::setprecision(4) << "CPI = " << mean;
+    if (config.simpoint_path.empty() && windows.size() > 1) {
+        // 各窗口等权，按t分布给出95%置信区间
+        static const double t_975[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365,
+                                       2.306,  2.262, 2.228, 2.201, 2.179, 2.160, 2.145,
+                                       2.131,  2.120, 2.110, 2.101, 2.093, 2.086, 2.080,
+                                       2.074,  2.069, 2.064, 2.060, 2.056, 2.052, 2.048,
+                                       2.045,  2.042};
+        const size_t n = windows.size();
+        double variance = 0;
+        for (const SampleWindow &window : windows) {
+            double cpi = static_cast<double>(window.cycles) / window.instructions;
+            variance += (cpi - mean) * (cpi - mean);
+        }
+        variance /= n - 1;
+        double t = n - 1 <= 30 ? t_975[n - 2] : 1.960;
+        double half_width = t * std::sqrt(variance / n);
+        std::cerr << " +/- " << half_width << " (95% CI)";
+    }
+    std::cerr << ", extrapolated cycles = " << std::setprecision(0)
+              << mean * total_instructions << std::endl;
 }
 
 void RISCV_Simulator::tick() {
-    cpu_core->tick(cpu);
-    
-    if (cpu.fetch_stalled()) {
+    events->run_until(cpu_core->get_cycle_count());
+    cpu_core->tick(cpu.core, cpu.memory);
+    if (cpu_core->is_waiting()) {
+        skip_idle_cycles();
+    }
+
+    if (checker && checker->has_failed()) {
         is_halted = true;
         return;
     }
 
-    if (cpu.pc() >= MEMORY_SIZE - 3) {
+    if (cpu.fetch_stalled()) {
         is_halted = true;
         return;
     }
 }
 
+void RISCV_Simulator::skip_idle_cycles() {
+    const uint64_t cycle = cpu_core->get_cycle_count();
+    const uint64_t target = idle_target(cycle);
+    if (target > cycle) {
+        cpu_core->skip_cycles(cpu.core, target - cycle);
+    }
+}
+
+uint64_t RISCV_Simulator::idle_target(uint64_t cycle) {
+    // 没有事件时不跳过任何周期：之后不会再有中断，视为死锁并停机
+    uint64_t target = events->next_cycle();
+    if (target == UINT64_MAX) {
+        std::cerr << "Error: WFI with no pending event at cycle " << cycle << ", deadlock"
+                  << std::endl;
+        deadlocked = true;
+        is_halted = true;
+        return cycle;
+    }
+    // 不越过需要保存检查点的周期
+    if (!config.checkpoint_path.empty()) {
+        if (config.checkpoint_at > cycle) {
+            target = std::min(target, config.checkpoint_at);
+        }
+        if (config.checkpoint_interval) {
+            target = std::min(target, (cycle / config.checkpoint_interval + 1) *
+                                          config.checkpoint_interval);
+        }
+    }
+    return target;
+}
+
 uint32_t RISCV_Simulator::fetch_instruction() {
     if (cpu.pc() >= MEMORY_SIZE - 3) {
         std::cout << "Error: Program Counter out of bounds!" << std::endl;
@@ -72,3 +600,66 @@ void RISCV_Simulator::print_result() {
     uint32_t result = cpu.Regs().get_value(10) & 0xFF;
     std::cout << std::dec << result << std::endl;
 }
+
+void RISCV_Simulator::print_stats() {
+    const uint64_t cycles = cpu_core->get_cycle_count();
+    const uint64_t instructions = cpu_core->get_instruction_count();
+    std::cerr << "Stats: x10 = 0x" << std::hex << std::setfill('0') << std::setw(8)
+              << cpu.Regs().get_value(10) << std::dec << std::setfill(' ') << ", " << cycles
+              << " cycles, " << instructions << " instructions, IPC " << std::fixed
+              << std::setprecision(4)
+              << (cycles ? static_cast<double>(instructions) / cycles : 0.0)
+              << std::defaultfloat << ", " << cpu_core->get_branch_mispredictions()
+              << " branch mispredictions" << std::endl;
+}
+
+template <CoreConfig Config>
+void RISCV_Simulator::print_core_stats(const BasicCPU<Config> &model) {
+    if (Config.rename_elimination) {
+        std::cerr << "Rename elimination: " << model.get_moves_eliminated() << " moves, "
+                  << model.get_constants_eliminated() << " constants" << std::endl;
+    }
+    if (config.fusion) {
+        std::cerr << "Fusion: " << model.get_fused_pairs(FusionKind::LuiAddi) << " lui+addi, "
+                  << model.get_fused_pairs(FusionKind::AuipcJalr) << " auipc+jalr, "
+                  << model.get_fused_pairs(FusionKind::SlliSrli) << " slli+srli" << std::endl;
+    }
+}
+
+void RISCV_Simulator::report_exception() {
+    std::cerr << std::hex << std::setfill('0');
+    switch (exception.cause) {
+    case ExceptionCause::IllegalInstruction:
+        std::cerr << "Illegal instruction 0x"
+                  << std::setw(InstructionProcessor::is_compressed(exception.tval) ? 4 : 8)
+                  << exception.tval;
+        break;
+    case ExceptionCause::Breakpoint:
+        std::cerr << "Breakpoint";
+        break;
+    case ExceptionCause::InstructionAccessFault:
+        std::cerr << "Instruction access fault";
+        break;
+    case ExceptionCause::LoadAddressMisaligned:
+        std::cerr << "Misaligned load from 0x" << std::setw(8) << exception.tval;
+        break;
+    case ExceptionCause::StoreAddressMisaligned:
+        std::cerr << "Misaligned store to 0x" << std::setw(8) << exception.tval;
+        break;
+    case ExceptionCause::LoadAccessFault:
+        std::cerr << "Load access fault at 0x" << std::setw(8) << exception.tval;
+        break;
+    case ExceptionCause::StoreAccessFault:
+        std::cerr << "Store access fault at 0x" << std::setw(8) << exception.tval;
+        break;
+    default:
+        std::cerr << "Exception " << std::dec << static_cast<uint32_t>(exception.cause)
+                  << std::hex;
+        break;
+    }
+    std::cerr << " at pc 0x" << std::setw(8) << exception.pc << std::dec << std::setfill(' ');
+    if (config.harts > 1) {
+        std::cerr << " on hart " << exception.hart;
+    }
+    std::cerr << std::endl;
+}
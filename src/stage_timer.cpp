@@ -0,0 +1,45 @@
+#include "../include/stage_timer.h"
+
+#include <iomanip>
+
+StageTimers::StageTimers() : start_ticks_(now()), start_time_(std::chrono::steady_clock::now()) {
+    for (uint64_t &ticks : ticks_) {
+        ticks = 0;
+    }
+}
+
+void StageTimers::merge(const StageTimers &other) {
+    for (int i = 0; i < static_cast<int>(PipelineStage::Count); ++i) {
+        ticks_[i] += other.ticks_[i];
+    }
+}
+
+void StageTimers::report(std::ostream &out, uint64_t cycles) const {
+    static const char *const NAMES[] = {"commit", "writeback", "execute", "dispatch",
+                                        "decode",  "fetch"};
+    const double elapsed_ns = std::chrono::duration<double, std::nano>(
+                                  std::chrono::steady_clock::now() - start_time_)
+                                  .count();
+    const uint64_t elapsed_ticks = now() - start_ticks_;
+    const double ns_per_tick = elapsed_ticks ? elapsed_ns / elapsed_ticks : 0.0;
+
+    const uint64_t total = ticks_[static_cast<int>(PipelineStage::Tick)];
+    uint64_t stages = 0;
+    auto line = [&](const char *name, uint64_t ticks) {
+        const double ns = ticks * ns_per_tick;
+        out << "  " << std::left << std::setw(10) << name << std::right << std::setw(10)
+            << ns / 1e6 << " ms " << std::setw(6)
+            << (total ? 100.0 * ticks / total : 0.0) << "% " << std::setw(8)
+            << (cycles ? ns / cycles : 0.0) << " ns/cycle\n";
+    };
+
+    out << "Stage host time over " << cycles << " cycles:\n" << std::fixed << std::setprecision(2);
+    for (int i = 0; i < static_cast<int>(PipelineStage::Tick); ++i) {
+        line(NAMES[i], ticks_[i]);
+        stages += ticks_[i];
+    }
+    // 状态拷贝、热点分析等不属于任何阶段的部分
+    line("other", total > stages ? total - stages : 0);
+    line("total", total);
+    out << std::defaultfloat << std::flush;
+}
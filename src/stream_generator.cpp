@@ -0,0 +1,320 @@
+#include "../include/stream_generator.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+// 生成器内部的指令表示，同时用于编码和参考模型
+enum class Op { Add, Sub, Xor, Addi, Xori, Slli, Srli, Lui, Lw, Sw, Bltu, Beq, Bne, Jal, Halt };
+
+struct StreamOp {
+    Op op;
+    uint32_t rd, rs1, rs2;
+    int32_t imm; // 分支为字节偏移
+};
+
+const uint32_t DATA_BASE = 0x80000;
+const uint32_t STORE_SLOTS = 32; // Store写 [0, 128)
+const uint32_t LOAD_OFFSET = 256; // 不与Store重叠的Load读 [256, 384)
+const uint32_t LOAD_SLOTS = 32;
+const uint32_t DATA_WORDS = (LOAD_OFFSET / 4) + LOAD_SLOTS;
+
+// 固定用途的寄存器
+const uint32_t REG_BASE = 8;       // 数据区基址
+const uint32_t REG_COUNT = 9;      // 循环计数
+const uint32_t REG_RESULT = 10;    // 结果
+const uint32_t REG_THRESHOLD = 29; // 分支阈值
+const uint32_t REG_TEMP = 30;
+const uint32_t REG_RANDOM = 31;    // xorshift状态
+
+// 工作寄存器，依赖链在其中轮转
+const uint32_t POOL[] = {5, 6, 7, 11, 12, 13, 14, 15, 16, 17,
+                         18, 19, 20, 21, 22, 23, 24, 25, 26, 27};
+
+const uint32_t HALT_WORD = 0x0ff00513;
+
+// splitmix64，保证不同平台生成相同的程序
+class Random {
+  public:
+    explicit Random(uint64_t seed) : state_(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    uint32_t below(uint32_t n) { return static_cast<uint32_t>(next() % n); }
+    double uniform() { return static_cast<double>(next() >> 11) / 9007199254740992.0; }
+
+  private:
+    uint64_t state_;
+};
+
+uint32_t encode(const StreamOp &s) {
+    const uint32_t imm = static_cast<uint32_t>(s.imm);
+    auto r_type = [&](uint32_t funct7, uint32_t funct3) {
+        return funct7 << 25 | s.rs2 << 20 | s.rs1 << 15 | funct3 << 12 | s.rd << 7 | 0x33;
+    };
+    auto i_type = [&](uint32_t funct3, uint32_t opcode) {
+        return (imm & 0xFFF) << 20 | s.rs1 << 15 | funct3 << 12 | s.rd << 7 | opcode;
+    };
+    auto b_type = [&](uint32_t funct3) {
+        return (imm >> 12 & 1) << 31 | (imm >> 5 & 0x3F) << 25 | s.rs2 << 20 | s.rs1 << 15 |
+               funct3 << 12 | (imm >> 1 & 0xF) << 8 | (imm >> 11 & 1) << 7 | 0x63;
+    };
+    switch (s.op) {
+    case Op::Add:
+        return r_type(0, 0);
+    case Op::Sub:
+        return r_type(0x20, 0);
+    case Op::Xor:
+        return r_type(0, 4);
+    case Op::Addi:
+        return i_type(0, 0x13);
+    case Op::Xori:
+        return i_type(4, 0x13);
+    case Op::Slli:
+        return i_type(1, 0x13);
+    case Op::Srli:
+        return i_type(5, 0x13);
+    case Op::Lui:
+        return (imm & 0xFFFFF000) | s.rd << 7 | 0x37;
+    case Op::Lw:
+        return i_type(2, 0x03);
+    case Op::Sw:
+        return (imm >> 5 & 0x7F) << 25 | s.rs2 << 20 | s.rs1 << 15 | 2 << 12 |
+               (imm & 0x1F) << 7 | 0x23;
+    case Op::Bltu:
+        return b_type(6);
+    case Op::Beq:
+        return b_type(0);
+    case Op::Bne:
+        return b_type(1);
+    case Op::Jal:
+        return (imm >> 20 & 1) << 31 | (imm >> 1 & 0x3FF) << 21 | (imm >> 11 & 1) << 20 |
+               (imm >> 12 & 0xFF) << 12 | s.rd << 7 | 0x6F;
+    case Op::Halt:
+    default:
+        return HALT_WORD;
+    }
+}
+
+class Builder {
+  public:
+    std::vector<StreamOp> ops;
+
+    void emit(Op op, uint32_t rd, uint32_t rs1, uint32_t rs2, int32_t imm) {
+        ops.push_back({op, rd, rs1, rs2, imm});
+    }
+    // li：lui + addi，低12位按有符号处理
+    void load_immediate(uint32_t rd, uint32_t value) {
+        const uint32_t upper = (value + 0x800) & 0xFFFFF000;
+        emit(Op::Lui, rd, 0, 0, static_cast<int32_t>(upper));
+        emit(Op::Addi, rd, rd, 0, static_cast<int32_t>(value - upper));
+    }
+};
+
+// 参考模型：按生成器的指令表示执行到停机，返回x10
+uint32_t run_model(const std::vector<StreamOp> &ops, std::vector<uint32_t> data,
+                   uint64_t &instructions) {
+    uint32_t regs[32] = {};
+    size_t index = 0;
+    instructions = 0;
+    auto word = [&](uint32_t address) -> uint32_t & { return data[(address - DATA_BASE) / 4]; };
+    while (ops[index].op != Op::Halt) {
+        const StreamOp &s = ops[index];
+        const uint32_t a = regs[s.rs1];
+        const uint32_t b = regs[s.rs2];
+        const uint32_t imm = static_cast<uint32_t>(s.imm);
+        uint32_t result = 0;
+        size_t next = index + 1;
+        bool writes = true;
+        switch (s.op) {
+        case Op::Add:
+            result = a + b;
+            break;
+        case Op::Sub:
+            result = a - b;
+            break;
+        case Op::Xor:
+            result = a ^ b;
+            break;
+        case Op::Addi:
+            result = a + imm;
+            break;
+        case Op::Xori:
+            result = a ^ imm;
+            break;
+        case Op::Slli:
+            result = a << (imm & 31);
+            break;
+        case Op::Srli:
+            result = a >> (imm & 31);
+            break;
+        case Op::Lui:
+            result = imm;
+            break;
+        case Op::Lw:
+            result = word(a + imm);
+            break;
+        case Op::Sw:
+            word(a + imm) = b;
+            writes = false;
+            break;
+        case Op::Bltu:
+        case Op::Beq:
+        case Op::Bne:
+            if (s.op == Op::Bltu ? a < b : s.op == Op::Beq ? a == b : a != b) {
+                next = index + s.imm / 4;
+            }
+            writes = false;
+            break;
+        case Op::Jal:
+            next = index + s.imm / 4;
+            writes = false;
+            break;
+        case Op::Halt:
+            break;
+        }
+        if (writes && s.rd != 0) {
+            regs[s.rd] = result;
+        }
+        index = next;
+        ++instructions;
+    }
+    return regs[REG_RESULT];
+}
+
+} // namespace
+
+GeneratedStream StreamGenerator::generate(const StreamConfig &config, bool run_reference) {
+    Random random(config.seed);
+    const uint32_t distance =
+        std::clamp(config.dependency_distance, 1u, MAX_DEPENDENCY_DISTANCE);
+    const uint32_t pool_size = distance + 1;
+    const uint32_t body_length = std::clamp(config.body_length, 1u, MAX_BODY_LENGTH);
+
+    GeneratedStream stream;
+    stream.data_base = DATA_BASE;
+    stream.data.resize(DATA_WORDS);
+    for (uint32_t i = 0; i < LOAD_SLOTS; ++i) {
+        stream.data[LOAD_OFFSET / 4 + i] = static_cast<uint32_t>(random.next());
+    }
+
+    Builder b;
+    b.load_immediate(REG_BASE, DATA_BASE);
+    b.load_immediate(REG_COUNT, std::max(config.iterations, 1u));
+    const double bias = std::clamp(config.branch_bias, 0.0, 1.0);
+    b.load_immediate(REG_THRESHOLD, static_cast<uint32_t>(bias * 4294967295.0));
+    b.load_immediate(REG_RANDOM, static_cast<uint32_t>(random.next()) | 1);
+    for (uint32_t i = 0; i < pool_size; ++i) {
+        b.load_immediate(POOL[i], static_cast<uint32_t>(random.next()));
+    }
+
+    const double total = config.alu_weight + config.branch_weight + config.load_weight +
+                         config.store_weight;
+    const double alu = total > 0 ? config.alu_weight / total : 1.0;
+    const double branch = total > 0 ? alu + config.branch_weight / total : 1.0;
+    const double load = total > 0 ? branch + config.load_weight / total : 1.0;
+
+    const size_t loop = b.ops.size();
+    int32_t last_store = -1;             // 最近一条Store的偏移
+    std::vector<size_t> pending_aliases; // 本轮中尚无Store可读，读上一轮最后一条Store
+    uint32_t stores = 0;
+    for (uint32_t i = 0; i < body_length; ++i) {
+        const uint32_t rd = POOL[i % pool_size];
+        const uint32_t rs1 = POOL[(i + 1) % pool_size]; // distance条之前写入
+        const uint32_t rs2 = POOL[i % pool_size];       // distance+1条之前写入
+        const double kind = random.uniform();
+        auto emit_alu = [&]() {
+            // 移位量取自立即数，避免寄存器移位把值逐渐清零
+            static const Op ops[] = {Op::Add, Op::Sub, Op::Xor, Op::Addi, Op::Xori, Op::Slli,
+                                     Op::Srli};
+            const Op op = ops[random.below(7)];
+            const int32_t imm = op == Op::Slli || op == Op::Srli
+                                    ? static_cast<int32_t>(1 + random.below(7))
+                                    : static_cast<int32_t>(random.below(4096)) - 2048;
+            b.emit(op, rd, rs1, rs2, imm);
+        };
+        if (kind < alu) {
+            emit_alu();
+        } else if (kind < branch) {
+            // 左移不超过24位，比较的高位仍是均匀分布的随机位
+            b.emit(Op::Slli, REG_TEMP, REG_RANDOM, 0, static_cast<int32_t>(random.below(24)));
+            b.emit(Op::Bltu, 0, REG_TEMP, REG_THRESHOLD, 8);
+            emit_alu();
+        } else if (kind < load) {
+            if (random.uniform() < config.alias_rate) {
+                if (last_store < 0) {
+                    pending_aliases.push_back(b.ops.size());
+                }
+                b.emit(Op::Lw, rd, REG_BASE, 0, last_store);
+            } else {
+                b.emit(Op::Lw, rd, REG_BASE, 0,
+                       static_cast<int32_t>(LOAD_OFFSET + 4 * random.below(LOAD_SLOTS)));
+            }
+        } else {
+            last_store = static_cast<int32_t>(4 * (stores++ % STORE_SLOTS));
+            b.emit(Op::Sw, 0, REG_BASE, rs1, last_store);
+        }
+    }
+    // 循环体中没有Store时这些Load读不被写的区域
+    for (size_t index : pending_aliases) {
+        b.ops[index].imm = last_store >= 0 ? last_store : static_cast<int32_t>(LOAD_OFFSET);
+    }
+
+    // 更新xorshift状态，循环控制
+    b.emit(Op::Slli, REG_TEMP, REG_RANDOM, 0, 13);
+    b.emit(Op::Xor, REG_RANDOM, REG_RANDOM, REG_TEMP, 0);
+    b.emit(Op::Srli, REG_TEMP, REG_RANDOM, 0, 17);
+    b.emit(Op::Xor, REG_RANDOM, REG_RANDOM, REG_TEMP, 0);
+    b.emit(Op::Slli, REG_TEMP, REG_RANDOM, 0, 5);
+    b.emit(Op::Xor, REG_RANDOM, REG_RANDOM, REG_TEMP, 0);
+    b.emit(Op::Addi, REG_COUNT, REG_COUNT, 0, -1);
+    const int32_t back = -4 * static_cast<int32_t>(b.ops.size() - loop);
+    if (back >= -4096) {
+        b.emit(Op::Bne, 0, REG_COUNT, 0, back);
+    } else {
+        // 超出条件分支的范围，用beq跳出循环 + jal跳回
+        b.emit(Op::Beq, 0, REG_COUNT, 0, 8);
+        b.emit(Op::Jal, 0, 0, 0, back - 4);
+    }
+
+    b.emit(Op::Addi, REG_RESULT, REG_RANDOM, 0, 0);
+    for (uint32_t i = 0; i < pool_size; ++i) {
+        b.emit(Op::Xor, REG_RESULT, REG_RESULT, POOL[i], 0);
+    }
+    b.emit(Op::Halt, 0, 0, 0, 0);
+
+    stream.code.reserve(b.ops.size());
+    for (const StreamOp &s : b.ops) {
+        stream.code.push_back(encode(s));
+    }
+    stream.checksum = 0;
+    stream.instructions = 0;
+    if (run_reference) {
+        stream.checksum = run_model(b.ops, stream.data, stream.instructions);
+    }
+    return stream;
+}
+
+void StreamGenerator::write_image(std::ostream &out, const GeneratedStream &stream) {
+    auto write_words = [&out](uint32_t address, const std::vector<uint32_t> &words) {
+        char text[16];
+        std::snprintf(text, sizeof(text), "@%08X\n", address);
+        out << text;
+        for (size_t i = 0; i < words.size(); ++i) {
+            for (int byte = 0; byte < 4; ++byte) {
+                std::snprintf(text, sizeof(text), "%02X ", words[i] >> (byte * 8) & 0xFF);
+                out << text;
+            }
+            if (i % 4 == 3 || i + 1 == words.size()) {
+                out << '\n';
+            }
+        }
+    };
+    write_words(0, stream.code);
+    write_words(stream.data_base, stream.data);
+}
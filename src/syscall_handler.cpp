@@ -0,0 +1,129 @@
+#include "../include/syscall_handler.h"
+
+#include <iostream>
+
+// Linux errno 取负值作为失败时的返回值
+static const uint32_t ERR_BADF = static_cast<uint32_t>(-9);
+static const uint32_t ERR_FAULT = static_cast<uint32_t>(-14);
+static const uint32_t ERR_NOSYS = static_cast<uint32_t>(-38);
+
+// 客户程序栈从内存顶部向下增长，堆不允许越过这一区域
+static const uint32_t STACK_RESERVE = 64 * 1024;
+
+SyscallHandler::SyscallHandler(std::istream &input, uint32_t heap_start)
+    : input_(input), brk_(heap_start), exited_(false), exit_code_(0) {}
+
+SyscallHandler::~SyscallHandler() { flush(); }
+
+void SyscallHandler::handle(Registers &regs, uint8_t memory[]) {
+    std::lock_guard<std::recursive_mutex> guard(lock_);
+    const uint32_t number = regs.get_value(17);
+    const uint32_t a0 = regs.get_value(10);
+    const uint32_t a1 = regs.get_value(11);
+    const uint32_t a2 = regs.get_value(12);
+
+    uint32_t result;
+    switch (number) {
+    case SYS_WRITE:
+        result = sys_write(a0, a1, a2, memory);
+        break;
+    case SYS_READ:
+        result = sys_read(a0, a1, a2, memory);
+        break;
+    case SYS_BRK:
+        result = sys_brk(a0);
+        break;
+    case SYS_EXIT:
+    case SYS_EXIT_GROUP:
+        exited_ = true;
+        exit_code_ = a0;
+        flush();
+        return;
+    case SYS_CLOSE:
+        result = 0;
+        break;
+    case SYS_FSTAT:
+        // 不提供文件信息，newlib会把标准输出当作普通文件处理
+        result = ERR_NOSYS;
+        break;
+    default:
+        cerr << "Warning: unsupported syscall " << number << std::endl;
+        result = ERR_NOSYS;
+        break;
+    }
+    regs.set_value(10, result);
+}
+
+uint32_t SyscallHandler::sys_write(uint32_t fd, uint32_t buf, uint32_t count,
+                                   const uint8_t memory[]) {
+    if (fd != 1 && fd != 2) {
+        return ERR_BADF;
+    }
+    if (buf >= MEMORY_SIZE || count > MEMORY_SIZE - buf) {
+        return ERR_FAULT;
+    }
+    write_console(fd, reinterpret_cast<const char *>(&memory[buf]), count);
+    return count;
+}
+
+uint32_t SyscallHandler::sys_read(uint32_t fd, uint32_t buf, uint32_t count, uint8_t memory[]) {
+    if (fd != 0) {
+        return ERR_BADF;
+    }
+    if (buf >= MEMORY_SIZE || count > MEMORY_SIZE - buf) {
+        return ERR_FAULT;
+    }
+    // 交互式使用时先把提示信息输出
+    flush();
+    input_.read(reinterpret_cast<char *>(&memory[buf]), count);
+    uint32_t got = static_cast<uint32_t>(input_.gcount());
+    input_.clear();
+    return got;
+}
+
+uint32_t SyscallHandler::sys_brk(uint32_t addr) {
+    if (addr != 0 && addr <= MEMORY_SIZE - STACK_RESERVE) {
+        brk_ = addr;
+    }
+    return brk_;
+}
+
+void SyscallHandler::write_console(uint32_t fd, const char *data, size_t size) {
+    std::lock_guard<std::recursive_mutex> guard(lock_);
+    std::string &buffer = fd == 2 ? stderr_buffer_ : stdout_buffer_;
+    buffer.append(data, size);
+    if (buffer.size() >= OUTPUT_BUFFER_SIZE) {
+        flush();
+    }
+}
+
+bool SyscallHandler::read_console(char &c) {
+    std::lock_guard<std::recursive_mutex> guard(lock_);
+    flush();
+    if (!input_.get(c)) {
+        input_.clear();
+        return false;
+    }
+    return true;
+}
+
+bool SyscallHandler::console_ready() {
+    std::lock_guard<std::recursive_mutex> guard(lock_);
+    flush();
+    bool ready = input_.peek() != std::char_traits<char>::eof();
+    input_.clear();
+    return ready;
+}
+
+void SyscallHandler::flush() {
+    std::lock_guard<std::recursive_mutex> guard(lock_);
+    if (!stdout_buffer_.empty()) {
+        cout.write(stdout_buffer_.data(), stdout_buffer_.size());
+        cout.flush();
+        stdout_buffer_.clear();
+    }
+    if (!stderr_buffer_.empty()) {
+        cerr.write(stderr_buffer_.data(), stderr_buffer_.size());
+        stderr_buffer_.clear();
+    }
+}
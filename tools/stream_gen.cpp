@@ -0,0 +1,76 @@
+// 合成指令流生成器：输出load_program格式的程序，期望的x10与动态指令数写到标准错误
+
+#include "../include/stream_generator.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static void print_usage(const char *prog) {
+    std::cerr << "Usage: " << prog << " [options] > program.data\n"
+              << "  --body <n>              loop body slots (256)\n"
+              << "  --iterations <n>        loop iterations (1000)\n"
+              << "  --distance <n>          dependency distance, 1..19 (4)\n"
+              << "  --branch-bias <p>       probability a branch is taken (0.5)\n"
+              << "  --alias-rate <p>        fraction of loads reading a stored address (0.5)\n"
+              << "  --mix <a,b,l,s>         ALU/branch/load/store weights (0.6,0.15,0.15,0.1)\n"
+              << "  --seed <n>              random seed (1)\n"
+              << "  -o <file>               write to <file> instead of stdout\n";
+}
+
+int main(int argc, char *argv[]) {
+    StreamConfig config;
+    const char *output = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--body") == 0 && i + 1 < argc) {
+            config.body_length = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            config.iterations = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (std::strcmp(argv[i], "--distance") == 0 && i + 1 < argc) {
+            config.dependency_distance =
+                static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (std::strcmp(argv[i], "--branch-bias") == 0 && i + 1 < argc) {
+            config.branch_bias = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--alias-rate") == 0 && i + 1 < argc) {
+            config.alias_rate = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--mix") == 0 && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%lf,%lf,%lf,%lf", &config.alu_weight,
+                            &config.branch_weight, &config.load_weight,
+                            &config.store_weight) != 4) {
+                print_usage(argv[0]);
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            config.seed = std::strtoull(argv[++i], nullptr, 0);
+        } else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (config.body_length == 0 || config.body_length > StreamGenerator::MAX_BODY_LENGTH ||
+        config.iterations == 0 || config.dependency_distance == 0 ||
+        config.dependency_distance > StreamGenerator::MAX_DEPENDENCY_DISTANCE) {
+        std::cerr << "--body must be 1.." << StreamGenerator::MAX_BODY_LENGTH
+                  << ", --iterations positive and --distance 1.."
+                  << StreamGenerator::MAX_DEPENDENCY_DISTANCE << std::endl;
+        return 2;
+    }
+
+    const GeneratedStream stream = StreamGenerator::generate(config);
+    if (output) {
+        std::ofstream out(output);
+        if (!out) {
+            std::cerr << "Error: cannot write " << output << std::endl;
+            return 1;
+        }
+        StreamGenerator::write_image(out, stream);
+    } else {
+        StreamGenerator::write_image(std::cout, stream);
+    }
+    std::cerr << "x10 = 0x" << std::hex << stream.checksum << std::dec << ", "
+              << stream.instructions << " instructions" << std::endl;
+    return 0;
+}
@@ -0,0 +1,143 @@
+# RV32A：64轮，对一个16字的数组依次执行九种AMO，前后夹着普通Load/Store，检查AMO与
+# 相邻访存的顺序；LR/SC覆盖成功、无保留、保留已被SC用掉与地址不同四种情况；
+# 非对齐与非映射地址的AMO、LR陷入处理程序。返回各旧值、SC结果与数组内容的校验和
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+    .equ ROUNDS, 64
+main:
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    la t0, trap_handler
+    csrw mtvec, t0
+    li s0, 0x10000              # 数组
+    li s1, 0                    # 校验和
+    li s2, 0                    # 轮数
+    li s3, 0x9E3779B9           # 操作数
+    li s4, 0                    # 陷入的mcause与mtval累加
+
+    # 数组初始化为 i * 0x01010101 - 8
+    li t0, 0
+.Linit:
+    li t1, 0x01010101
+    mul t1, t1, t0
+    addi t1, t1, -8
+    slli t2, t0, 2
+    add t2, s0, t2
+    sw t1, 0(t2)
+    addi t0, t0, 1
+    li t1, 16
+    blt t0, t1, .Linit
+
+.Lround:
+    andi t0, s2, 15
+    slli t0, t0, 2
+    add a1, s0, t0              # 本轮的元素
+    andi t0, s2, 7
+    slli t0, t0, 2
+    add a2, s0, t0              # 另一个元素，与a1可能相同
+
+    sw s3, 0(a1)                # AMO读到的应是这次Store的值
+    amoswap.w t1, s2, (a1)
+    amoadd.w t2, s3, (a1)
+    amoxor.w t3, s3, (a2)
+    amoand.w t4, s3, (a1)
+    amoor.w t5, s2, (a2)
+    amomin.w t6, s3, (a1)
+    amomax.w a3, s3, (a2)
+    amominu.w a4, s3, (a1)
+    amomaxu.w a5, s2, (a2)
+    lw a6, 0(a1)                # 应读到AMO写入的值
+    add s1, s1, t1
+    xor s1, s1, t2
+    add s1, s1, t3
+    xor s1, s1, t4
+    add s1, s1, t5
+    xor s1, s1, t6
+    add s1, s1, a3
+    xor s1, s1, a4
+    add s1, s1, a5
+    xor s1, s1, a6
+
+    # LR/SC：成功一次后保留失效，再SC失败；没有保留、保留在其他地址时都失败
+    lr.w t1, (a1)
+    addi t1, t1, 1
+    sc.w t2, t1, (a1)           # 0
+    sc.w t3, s3, (a1)           # 1
+    addi t0, a1, 64
+    lr.w t4, (t0)
+    sc.w t5, s3, (a1)           # 1，保留在a1+64
+    sc.w t6, s3, (t0)           # 1，保留已被上一条SC清除
+    slli t2, t2, 3
+    slli t3, t3, 2
+    slli t5, t5, 1
+    or t2, t2, t3
+    or t2, t2, t5
+    or t2, t2, t6
+    add s1, s1, t2
+    add s1, s1, t4
+    slli t0, s1, 7
+    srli s1, s1, 25
+    or s1, s1, t0
+
+    # xorshift更新操作数
+    slli t0, s3, 13
+    xor s3, s3, t0
+    srli t0, s3, 17
+    xor s3, s3, t0
+    slli t0, s3, 5
+    xor s3, s3, t0
+    addi s2, s2, 1
+    li t0, ROUNDS
+    blt s2, t0, .Lround
+
+    # 非对齐与非映射地址的原子指令引发异常，目标寄存器不变
+    li t1, 0
+    addi t0, s0, 2
+    amoadd.w t1, s3, (t0)       # StoreAddressMisaligned
+    lr.w t1, (t0)               # LoadAddressMisaligned
+    li t0, 0x40000000
+    amoswap.w t1, s3, (t0)      # StoreAccessFault
+    lr.w t1, (t0)               # LoadAccessFault
+    sc.w t1, s3, (t0)           # StoreAccessFault
+    add s1, s1, t1
+
+    # 数组内容计入校验和
+    li t0, 0
+.Lsum:
+    slli t1, t0, 2
+    add t1, s0, t1
+    lw t1, 0(t1)
+    xor s1, s1, t1
+    slli t2, s1, 5
+    srli s1, s1, 27
+    or s1, s1, t2
+    addi t0, t0, 1
+    li t1, 16
+    blt t0, t1, .Lsum
+
+    # a0 = 校验和 ^ mcause与mtval累加 << 24
+    slli a0, s4, 24
+    xor a0, a0, s1
+    lw ra, 12(sp)
+    addi sp, sp, 16
+    ret
+
+# 只使用t5、t6与s4；原子指令都是4字节
+    .p2align 2
+trap_handler:
+    csrr t5, mcause
+    bltz t5, .Lunexpected
+    add s4, s4, t5
+    csrr t6, mtval
+    add s4, s4, t6
+    csrr t6, mepc
+    addi t6, t6, 4
+    csrw mepc, t6
+    mret
+.Lunexpected:
+    li a0, -1
+    .word 0x0ff00513
@@ -0,0 +1,19 @@
+#!/bin/sh
+# 用llvm-mc把 workloads/*.s 汇编为 load_program 读取的 .data 格式
+# 用法：workloads/assemble.sh [file.s ...]，不带参数时处理全部
+set -e
+cd "$(dirname "$0")"
+MC=${LLVM_MC:-llvm-mc}
+OBJCOPY=${LLVM_OBJCOPY:-llvm-objcopy}
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+[ $# -gt 0 ] || set -- *.s
+for source in "$@"; do
+    name=$(basename "$source" .s)
+    "$MC" -filetype=obj -triple=riscv32 -mattr=+m,+a,-relax "$source" -o "$tmp/$name.o"
+    "$OBJCOPY" -O binary --only-section=.text "$tmp/$name.o" "$tmp/$name.bin"
+    {
+        echo "@00000000"
+        od -An -v -tx1 -w16 "$tmp/$name.bin" | tr 'a-f' 'A-F' | sed 's/^ //; s/$/ /'
+    } > "$name.data"
+done
@@ -0,0 +1,102 @@
+# CSR指令：64轮对mscratch、mtvec、mie、mstatus、mepc依次做CSRRW/CSRRS/CSRRC及其立即数形式，
+# 累加读出的旧值（含WARL字段的截断）；核对只读CSR，以及一段循环前后minstret的差值
+# 与mcycle的单调性。结果与时序无关，各配置相同
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+    .equ ROUNDS, 64
+main:
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    li s0, 0                    # 旧值校验和
+    li s1, 0                    # 轮数
+    li s2, 0x9E3779B9           # 写入的值
+
+.Lround:
+    csrrw t0, mscratch, s2
+    csrrs t1, mscratch, s1
+    csrrc t2, mscratch, s0
+    csrrwi t3, mscratch, 21
+    csrrsi t4, mscratch, 10
+    csrrci t5, mscratch, 1
+    csrr t6, mscratch
+    add s0, s0, t0
+    xor s0, s0, t1
+    add s0, s0, t2
+    xor s0, s0, t3
+    add s0, s0, t4
+    xor s0, s0, t5
+    add s0, s0, t6
+
+    # mtvec只保留direct与vectored两种模式，mie只保留MSIE、MTIE、MEIE
+    csrrw t0, mtvec, s2
+    csrrw t1, mtvec, zero
+    csrrs t2, mie, s2
+    csrrc t3, mie, s1
+    csrrw t4, mie, zero
+    # mstatus只保留MIE、MPIE，MPP读出恒为M；mie为0时打开MIE也不会有中断
+    csrrsi t5, mstatus, 8
+    csrrw t6, mstatus, s2
+    csrrw a1, mstatus, zero
+    csrrw a2, mepc, s2          # mepc的最低位恒为0
+    csrrw a3, mepc, zero
+    slli s0, s0, 1
+    add s0, s0, t0
+    xor s0, s0, t1
+    add s0, s0, t2
+    xor s0, s0, t3
+    add s0, s0, t4
+    xor s0, s0, t5
+    add s0, s0, t6
+    xor s0, s0, a1
+    add s0, s0, a2
+    xor s0, s0, a3
+
+    # xorshift更新写入的值
+    slli t0, s2, 13
+    xor s2, s2, t0
+    srli t0, s2, 17
+    xor s2, s2, t0
+    slli t0, s2, 5
+    xor s2, s2, t0
+    addi s1, s1, 1
+    li t0, ROUNDS
+    blt s1, t0, .Lround
+
+    # 只读CSR：misa、mhartid、mvendorid，写mhartid的结果见illegal
+    csrr t0, misa
+    csrr t1, mhartid
+    csrr t2, mvendorid
+    add s0, s0, t0
+    add s0, s0, t1
+    add s0, s0, t2
+
+    # 100次循环共200条指令，两次读minstret之间还有读mcycle的1条
+    csrr s3, mcycle
+    csrr s4, minstret
+    li t0, 100
+.Lcount:
+    addi t0, t0, -1
+    bnez t0, .Lcount
+    csrr s5, minstret
+    csrr s6, mcycle
+    sub s5, s5, s4              # 应为202
+    sltu s6, s3, s6             # mcycle递增为1
+
+    # 写minstret后读出的是写入值加上其间提交的指令数
+    li t0, 1000
+    csrw minstret, t0
+    csrr t1, minstret           # 1001
+
+    # a0 = 旧值校验和 ^ minstret差值 << 20 ^ mcycle单调 << 30 ^ 写入后的minstret
+    slli a0, s5, 20
+    xor a0, a0, s0
+    slli t0, s6, 30
+    xor a0, a0, t0
+    xor a0, a0, t1
+    lw ra, 12(sp)
+    addi sp, sp, 16
+    ret
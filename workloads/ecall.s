@@ -0,0 +1,94 @@
+# 系统调用：未设置mtvec，ECALL由模拟器代为执行。32轮依次调用brk扩展与回退堆、
+# write向标准输出写0字节、向无效fd与越界缓冲区write、read无效fd、close与fstat，
+# 累加各返回值；紧跟ECALL读取a0的指令须看到系统调用的结果。最后输出一行文字
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+    .equ ROUNDS, 32
+    .equ SYS_CLOSE, 57
+    .equ SYS_READ, 63
+    .equ SYS_WRITE, 64
+    .equ SYS_FSTAT, 80
+    .equ SYS_BRK, 214
+main:
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    li s0, 0                    # 返回值校验和
+    li s1, 0                    # 轮数
+    li a0, 0
+    li a7, SYS_BRK
+    ecall
+    mv s2, a0                   # 初始堆顶
+
+.Lround:
+    # 堆顶上移 (轮数+1)*64 字节，写入新区域后读回，再回退
+    addi t0, s1, 1
+    slli t0, t0, 6
+    add a0, s2, t0
+    li a7, SYS_BRK
+    ecall
+    sub t1, a0, s2              # 成功时为扩展的字节数
+    add s0, s0, t1
+    addi t2, a0, -4
+    sw s1, 0(t2)
+    lw t3, 0(t2)
+    add s0, s0, t3
+    mv a0, s2
+    ecall
+    sub t1, a0, s2
+    add s0, s0, t1              # 回退成功为0
+
+    li a0, 1
+    la a1, message
+    li a2, 0
+    li a7, SYS_WRITE
+    ecall
+    add s0, s0, a0              # 0
+    li a0, 7
+    ecall
+    add s0, s0, a0              # -EBADF
+    li a0, 1
+    li a1, -16
+    li a2, 32
+    ecall
+    add s0, s0, a0              # -EFAULT
+    li a0, 5
+    li a7, SYS_READ
+    ecall
+    add s0, s0, a0              # -EBADF
+    li a0, 3
+    li a7, SYS_CLOSE
+    ecall
+    add s0, s0, a0              # 0
+    li a7, SYS_FSTAT
+    ecall
+    add s0, s0, a0              # -ENOSYS
+    slli t0, s0, 3
+    srli s0, s0, 29
+    or s0, s0, t0
+    addi s1, s1, 1
+    li t0, ROUNDS
+    blt s1, t0, .Lround
+
+    # 超出内存的brk失败，返回原堆顶
+    li a0, -4096
+    li a7, SYS_BRK
+    ecall
+    xor s0, s0, a0
+    sub s0, s0, s2
+
+    li a0, 1
+    la a1, message
+    li a2, 6
+    li a7, SYS_WRITE
+    ecall
+    add a0, a0, s0              # write返回6
+    lw ra, 12(sp)
+    addi sp, sp, 16
+    ret
+
+message:
+    .ascii "ecall\n"
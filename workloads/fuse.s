@@ -0,0 +1,80 @@
+# 宏操作融合：64轮，每轮有3对lui+addi（含低12位为负的常数）、2对slli+srli零扩展、
+# 1对auipc+jalr远调用，以及压缩形式的c.lui+c.addi与c.slli+c.srli；另有目标寄存器不同、
+# 移位量不同的相似指令对，不应融合。打开 --fusion 时每轮融合4对lui+addi、3对slli+srli、
+# 1对auipc+jalr，加上初始化s2的li共257、192、64对，结果与不融合时相同
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+    .equ ROUNDS, 64
+main:
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    li s0, 0                    # 校验和
+    li s1, 0                    # 轮数
+    li s2, 0x9E3779B9           # 运算状态
+
+.Lround:
+    lui a1, 0x12345
+    addi a1, a1, 0x678
+    lui a2, 0x89abd
+    addi a2, a2, -0x211         # 0x89abcdef
+    lui a3, 0xfffff
+    addi a3, a3, -1             # -1
+    add s0, s0, a1
+    xor s0, s0, a2
+    add s0, s0, a3
+
+    slli a4, s2, 16
+    srli a4, a4, 16             # 低16位
+    slli a5, s2, 24
+    srli a5, a5, 24             # 低8位
+    slli a6, s2, 16
+    srli a7, a6, 16             # 目标寄存器不同，不融合
+    slli t0, s2, 16
+    srli t0, t0, 8              # 移位量不同，不融合
+    add s0, s0, a4
+    xor s0, s0, a5
+    add s0, s0, a7
+    xor s0, s0, t0
+
+    call mix                    # auipc ra + jalr ra
+
+    .option push
+    .option rvc
+    c.lui a1, 0x1f
+    c.addi a1, -3
+    c.slli a2, 20
+    c.srli a2, 20               # 低12位
+    .option pop
+    add s0, s0, a1
+    xor s0, s0, a2
+
+    lui a1, 0x40000
+    addi a2, a1, 5              # 目标寄存器不同，不融合
+    add s0, s0, a2
+
+    addi s1, s1, 1
+    li t0, ROUNDS
+    blt s1, t0, .Lround
+
+    mv a0, s0
+    lw ra, 12(sp)
+    addi sp, sp, 16
+    ret
+
+# xorshift更新s2并计入校验和
+mix:
+    slli t1, s2, 13
+    xor s2, s2, t1
+    srli t1, s2, 17
+    xor s2, s2, t1
+    slli t1, s2, 5
+    xor s2, s2, t1
+    slli t1, s0, 1
+    srli s0, s0, 31
+    or s0, s0, t1
+    xor s0, s0, s2
+    ret
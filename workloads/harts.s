@@ -0,0 +1,123 @@
+# 多核共享内存：每个hart在各自的数组上计算同一个校验和，每轮用AMO与LR/SC累加共享计数器；
+# 0号hart等所有hart完成后核对计数器与各hart写入共享数组的结果。x10与hart数无关，单核同样运行
+    .text
+_start:
+    csrr s11, mhartid
+    lui sp, 0x20                # 每个hart 4KB栈
+    slli t0, s11, 12
+    sub sp, sp, t0
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+    .equ ROUNDS, 48
+main:
+    li s0, 0x10000              # 共享计数器，各占一个缓存行
+    li t1, 1
+    amoadd.w zero, t1, (s0)     # +0：启动的hart数
+    slli t0, s11, 10
+    li s1, 0x11000
+    add s1, s1, t0              # 本hart的数组，256字
+    addi s2, s0, 128            # +128：AMO计数
+    addi s3, s0, 192            # +192：LR/SC计数
+    addi s6, s0, 64             # +64：完成的hart数
+
+    # 用xorshift填充数组
+    li t0, 0x9E3779B9
+    li t1, 0
+.Lfill:
+    slli t2, t0, 13
+    xor t0, t0, t2
+    srli t2, t0, 17
+    xor t0, t0, t2
+    slli t2, t0, 5
+    xor t0, t0, t2
+    slli t3, t1, 2
+    add t3, s1, t3
+    sw t0, 0(t3)
+    addi t1, t1, 1
+    li t2, 256
+    blt t1, t2, .Lfill
+
+    # 每轮 a[i] = a[i] * 31 + a[i+1]（a[256]取a[0]），并累加两个共享计数器
+    li s4, 0
+.Lround:
+    lw t5, 0(s1)
+    li t1, 0
+.Lmix:
+    slli t3, t1, 2
+    add t3, s1, t3
+    lw t2, 0(t3)
+    addi t4, t1, 1
+    li t6, 256
+    beq t4, t6, .Lwrap
+    lw t4, 4(t3)
+    j .Lstore
+.Lwrap:
+    mv t4, t5
+.Lstore:
+    slli t6, t2, 5
+    sub t2, t6, t2
+    add t2, t2, t4
+    sw t2, 0(t3)
+    addi t1, t1, 1
+    li t6, 256
+    blt t1, t6, .Lmix
+    li t1, 1
+    amoadd.w zero, t1, (s2)
+.Lretry:
+    lr.w t2, (s3)
+    addi t2, t2, 1
+    sc.w t3, t2, (s3)
+    bnez t3, .Lretry
+    addi s4, s4, 1
+    li t1, ROUNDS
+    blt s4, t1, .Lround
+
+    # 校验和写入共享数组，再累加完成数
+    li s5, 0
+    li t1, 0
+.Lsum:
+    slli t3, t1, 2
+    add t3, s1, t3
+    lw t2, 0(t3)
+    slli t4, s5, 7
+    srli s5, s5, 25
+    or s5, s5, t4
+    xor s5, s5, t2
+    addi t1, t1, 1
+    li t2, 256
+    blt t1, t2, .Lsum
+    slli t0, s11, 2
+    add t0, s0, t0
+    sw s5, 1024(t0)             # +1024：各hart的校验和
+    fence
+    li t1, 1
+    amoadd.w zero, t1, (s6)
+    mv a0, s5
+    bnez s11, .Lreturn
+
+    # 0号hart等待其他hart完成；fence之后的Load在等待结束后才执行
+.Lwait:
+    lw t1, 0(s6)
+    lw t2, 0(s0)
+    bne t1, t2, .Lwait
+    fence
+    li t0, ROUNDS
+    mul t0, t0, t2
+    lw t1, 0(s2)
+    bne t1, t0, .Lfail
+    lw t1, 0(s3)
+    bne t1, t0, .Lfail
+    li t1, 0
+.Lcheck:
+    slli t3, t1, 2
+    add t3, s0, t3
+    lw t3, 1024(t3)
+    bne t3, s5, .Lfail
+    addi t1, t1, 1
+    blt t1, t2, .Lcheck
+.Lreturn:
+    ret
+.Lfail:
+    li a0, -1
+    ret
@@ -0,0 +1,94 @@
+# 散列：16KB伪随机数据的FNV-1a与按位CRC32，以及700个键的开放寻址散列表插入
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+main:
+    li s0, 0x10000              # 数据缓冲区
+    li s1, 4096                 # 字数（16KB）
+    li t0, 0x9E3779B9           # xorshift状态
+    li t1, 0
+.Lgen:
+    slli t2, t0, 13
+    xor t0, t0, t2
+    srli t2, t0, 17
+    xor t0, t0, t2
+    slli t2, t0, 5
+    xor t0, t0, t2
+    slli t4, t1, 2
+    add t4, s0, t4
+    sw t0, 0(t4)
+    addi t1, t1, 1
+    blt t1, s1, .Lgen
+
+    # FNV-1a，逐字节
+    li s2, 0x811C9DC5
+    li t5, 16777619
+    mv t1, s0
+    li t2, 16384
+    add t2, s0, t2
+.Lfnv:
+    lbu t3, 0(t1)
+    xor s2, s2, t3
+    mul s2, s2, t5
+    addi t1, t1, 1
+    bltu t1, t2, .Lfnv
+
+    # CRC32（多项式0xEDB88320），前2048字节，逐位计算
+    li s3, -1
+    li t5, 0xEDB88320
+    mv t1, s0
+    li t2, 2048
+    add t2, s0, t2
+.Lcrc_byte:
+    lbu t3, 0(t1)
+    xor s3, s3, t3
+    li t4, 8
+.Lcrc_bit:
+    andi t6, s3, 1
+    neg t6, t6
+    and t6, t6, t5
+    srli s3, s3, 1
+    xor s3, s3, t6
+    addi t4, t4, -1
+    bnez t4, .Lcrc_bit
+    addi t1, t1, 1
+    bltu t1, t2, .Lcrc_byte
+    not s3, s3
+
+    # 散列表：1024个槽，键取自缓冲区前700个字，线性探测，统计探测次数
+    li s4, 0x18000              # 表基址，初始全0
+    li s5, 0                    # 探测次数
+    li t5, 0x9E3779B1           # 乘法散列常数
+    mv t1, s0
+    li t2, 2800
+    add t2, s0, t2
+.Linsert:
+    lw t3, 0(t1)
+    mul t4, t3, t5
+    srli t4, t4, 22             # 槽号
+.Lprobe:
+    slli t6, t4, 2
+    add t6, s4, t6
+    lw a1, 0(t6)
+    beqz a1, .Lstore
+    beq a1, t3, .Lnext_key
+    addi s5, s5, 1
+    addi t4, t4, 1
+    andi t4, t4, 1023
+    j .Lprobe
+.Lstore:
+    sw t3, 0(t6)
+.Lnext_key:
+    addi t1, t1, 4
+    bltu t1, t2, .Linsert
+
+    # a0 = fnv ^ rotl(crc, 7) ^ probes
+    slli t0, s3, 7
+    srli t1, s3, 25
+    or t0, t0, t1
+    xor a0, s2, t0
+    xor a0, a0, s5
+    ret
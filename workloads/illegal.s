@@ -0,0 +1,76 @@
+# 非法指令：16轮，每轮执行一组非法编码（全0的16位指令、全1、保留的操作码、未定义的funct7、
+# 不存在的CSR、写只读CSR），处理程序核对mcause并累加mtval中的指令编码，按指令长度跳过；
+# 错误预测路径上的非法指令不应陷入。返回陷入次数与mtval校验和的组合
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+    .equ ROUNDS, 16
+main:
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    la t0, trap_handler
+    csrw mtvec, t0
+    li s0, 0                    # 陷入次数
+    li s1, 0                    # mtval校验和
+    li s2, 0                    # 轮数
+    li s3, 0x12345              # 合法指令的运算结果
+
+.Lround:
+    .half 0x0000                # 全0的16位编码
+    .half 0x0001                # c.nop，恢复4字节对齐
+    addi s3, s3, 7
+    .word 0xffffffff
+    .word 0x0000707f            # 保留的操作码
+    slli t0, s3, 3
+    .word 0x7eb50533            # add a0, a0, a1 的funct7改为未定义的0x3f
+    xor s3, s3, t0
+    csrr t1, 0x7c0              # 不存在的CSR
+    csrw mhartid, s3            # 只读CSR
+    csrr t2, mhartid            # 只读CSR可以读
+    add s3, s3, t2
+    # 奇数轮第二条分支总会跳转，其后的非法指令只在错误预测的路径上
+    andi t0, s2, 1
+    beqz t0, .Lnext
+    bnez t0, .Lnext
+    .word 0xffffffff
+.Lnext:
+    addi s2, s2, 1
+    li t0, ROUNDS
+    blt s2, t0, .Lround
+
+    # a0 = 陷入次数 << 24 ^ mtval校验和 ^ 运算结果
+    slli a0, s0, 24
+    xor a0, a0, s1
+    xor a0, a0, s3
+    lw ra, 12(sp)
+    addi sp, sp, 16
+    ret
+
+# 只使用t3~t6与s0、s1
+    .p2align 2
+trap_handler:
+    csrr t3, mcause
+    li t4, 2                    # IllegalInstruction
+    bne t3, t4, .Lunexpected
+    addi s0, s0, 1
+    csrr t5, mtval
+    slli t6, s1, 5
+    srli s1, s1, 27
+    or s1, s1, t6
+    xor s1, s1, t5
+    csrr t4, mepc
+    lhu t6, 0(t4)
+    andi t6, t6, 3
+    li t3, 3
+    addi t4, t4, 2
+    bne t6, t3, .Lresume
+    addi t4, t4, 2
+.Lresume:
+    csrw mepc, t4
+    mret
+.Lunexpected:
+    li a0, -1
+    .word 0x0ff00513
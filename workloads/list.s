@@ -0,0 +1,53 @@
+# 链表遍历：2048个节点按跨步排列打散在内存中，遍历16遍求和
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+main:
+    li s0, 0x10000              # 节点数组，每个节点8字节：next, value
+    li s1, 2048
+    li s2, 1031                 # 跨步，与2048互质
+    li t0, 0xB5297A4D           # xorshift状态
+
+    # 第i个链表节点位于槽 (i * 1031) mod 2048，链到第i+1个节点
+    li t1, 0
+    li t6, 0                    # 当前槽
+.Lbuild:
+    add t3, t6, s2
+    andi t3, t3, 2047           # 下一个槽
+    slli t4, t6, 3
+    add t4, s0, t4              # 当前节点地址
+    slli t5, t3, 3
+    add t5, s0, t5              # 下一个节点地址
+    addi t1, t1, 1
+    bne t1, s1, .Llink
+    li t5, 0                    # 最后一个节点的next为空
+.Llink:
+    sw t5, 0(t4)
+    slli t2, t0, 13
+    xor t0, t0, t2
+    srli t2, t0, 17
+    xor t0, t0, t2
+    slli t2, t0, 5
+    xor t0, t0, t2
+    sw t0, 4(t4)
+    mv t6, t3
+    bne t1, s1, .Lbuild
+
+    li a0, 0                    # 和
+    li a1, 0                    # 访问的节点数
+    li t1, 16
+.Lpass:
+    mv t2, s0
+.Lwalk:
+    lw t3, 4(t2)
+    add a0, a0, t3
+    addi a1, a1, 1
+    lw t2, 0(t2)
+    bnez t2, .Lwalk
+    addi t1, t1, -1
+    bnez t1, .Lpass
+    add a0, a0, a1
+    ret
@@ -0,0 +1,83 @@
+# 矩阵乘法：24x24有符号整数矩阵 C = A * B，返回C的校验和
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+main:
+    li s0, 0x10000              # A
+    li s1, 0x11000              # B
+    li s2, 0x12000              # C
+    li s3, 24                   # N
+    mul s4, s3, s3              # N*N
+
+    # A与B按行优先连续存放，元素为 (x & 0xFF) - 128
+    li t0, 0x2545F491           # xorshift状态
+    li t1, 0
+    slli t6, s4, 1              # 两个矩阵共2*N*N个元素
+.Lgen:
+    slli t2, t0, 13
+    xor t0, t0, t2
+    srli t2, t0, 17
+    xor t0, t0, t2
+    slli t2, t0, 5
+    xor t0, t0, t2
+    andi t3, t0, 0xFF
+    addi t3, t3, -128
+    slli t4, t1, 2
+    add t4, s0, t4
+    bltu t1, s4, .Lstore_a
+    sub t4, t4, s0
+    slli t5, s4, 2
+    sub t4, t4, t5
+    add t4, s1, t4
+.Lstore_a:
+    sw t3, 0(t4)
+    addi t1, t1, 1
+    bltu t1, t6, .Lgen
+
+    slli s5, s3, 2              # 行跨距（字节）
+    li t0, 0                    # i
+.Li:
+    li t1, 0                    # j
+.Lj:
+    mul t3, t0, s5
+    add t3, s0, t3              # &A[i][0]
+    slli t4, t1, 2
+    add t4, s1, t4              # &B[0][j]
+    li t5, 0                    # 累加和
+    li t2, 0                    # k
+.Lk:
+    lw a1, 0(t3)
+    lw a2, 0(t4)
+    mul a3, a1, a2
+    add t5, t5, a3
+    addi t3, t3, 4
+    add t4, t4, s5
+    addi t2, t2, 1
+    blt t2, s3, .Lk
+    mul a4, t0, s5
+    slli a5, t1, 2
+    add a4, a4, a5
+    add a4, s2, a4
+    sw t5, 0(a4)
+    addi t1, t1, 1
+    blt t1, s3, .Lj
+    addi t0, t0, 1
+    blt t0, s3, .Li
+
+    # s = rotl(s, 3) + C[i]
+    li a0, 0
+    li t1, 0
+.Lsum:
+    slli t4, t1, 2
+    add t4, s2, t4
+    lw t3, 0(t4)
+    slli t2, a0, 3
+    srli a1, a0, 29
+    or a0, t2, a1
+    add a0, a0, t3
+    addi t1, t1, 1
+    blt t1, s4, .Lsum
+    ret
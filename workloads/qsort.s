@@ -0,0 +1,114 @@
+# 快速排序：对512个伪随机整数递归排序，返回有序性检查后的校验和
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+main:
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    li s0, 0x10000              # 数组基址
+    li s1, 512                  # 元素个数
+    li t0, 0x12345678           # xorshift状态
+    li t1, 0
+.Lgen:
+    slli t2, t0, 13
+    xor t0, t0, t2
+    srli t2, t0, 17
+    xor t0, t0, t2
+    slli t2, t0, 5
+    xor t0, t0, t2
+    srli t3, t0, 16
+    slli t4, t1, 2
+    add t4, s0, t4
+    sw t3, 0(t4)
+    addi t1, t1, 1
+    blt t1, s1, .Lgen
+
+    mv a0, s0
+    li a1, 0
+    addi a2, s1, -1
+    jal ra, quicksort
+
+    # s = rotl(s, 5) ^ a[i]；出现逆序时结果为0
+    li t0, 0
+    li t1, 0
+    li t5, 0
+    li t6, 0
+.Lcheck:
+    slli t4, t1, 2
+    add t4, s0, t4
+    lw t3, 0(t4)
+    slt t2, t3, t5
+    or t6, t6, t2
+    mv t5, t3
+    slli t2, t0, 5
+    srli a1, t0, 27
+    or t0, t2, a1
+    xor t0, t0, t3
+    addi t1, t1, 1
+    blt t1, s1, .Lcheck
+    beqz t6, .Lsorted
+    li t0, 0
+.Lsorted:
+    mv a0, t0
+    lw ra, 12(sp)
+    addi sp, sp, 16
+    ret
+
+# quicksort(a0=数组, a1=lo, a2=hi)，闭区间，Lomuto划分
+quicksort:
+    bge a1, a2, .Lqs_return
+    addi sp, sp, -32
+    sw ra, 28(sp)
+    sw s0, 24(sp)
+    sw s1, 20(sp)
+    sw s2, 16(sp)
+    sw s3, 12(sp)
+    mv s0, a0
+    mv s1, a1
+    mv s2, a2
+    slli t0, s2, 2
+    add t0, s0, t0
+    lw t1, 0(t0)                # pivot = a[hi]
+    addi t2, s1, -1             # i
+    mv t3, s1                   # j
+.Lqs_loop:
+    bge t3, s2, .Lqs_partitioned
+    slli t4, t3, 2
+    add t4, s0, t4
+    lw t5, 0(t4)
+    blt t1, t5, .Lqs_next
+    addi t2, t2, 1
+    slli t6, t2, 2
+    add t6, s0, t6
+    lw a3, 0(t6)
+    sw t5, 0(t6)
+    sw a3, 0(t4)
+.Lqs_next:
+    addi t3, t3, 1
+    j .Lqs_loop
+.Lqs_partitioned:
+    addi s3, t2, 1              # 枢轴的最终位置
+    slli t6, s3, 2
+    add t6, s0, t6
+    lw a3, 0(t6)
+    sw t1, 0(t6)
+    sw a3, 0(t0)
+    mv a0, s0
+    mv a1, s1
+    addi a2, s3, -1
+    jal ra, quicksort
+    mv a0, s0
+    addi a1, s3, 1
+    mv a2, s2
+    jal ra, quicksort
+    lw ra, 28(sp)
+    lw s0, 24(sp)
+    lw s1, 20(sp)
+    lw s2, 16(sp)
+    lw s3, 12(sp)
+    addi sp, sp, 32
+.Lqs_return:
+    ret
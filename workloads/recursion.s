@@ -0,0 +1,101 @@
+# 递归调用：fib(20)、汉诺塔(12层)的移动次数与Ackermann(2, 10)
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+main:
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    sw s0, 8(sp)
+    sw s1, 4(sp)
+    li a0, 20
+    jal ra, fib
+    mv s0, a0
+    li a0, 12
+    jal ra, hanoi
+    mv s1, a0
+    li a0, 2
+    li a1, 10
+    jal ra, ackermann
+    # a0 = fib ^ (hanoi << 16) ^ ack
+    slli s1, s1, 16
+    xor a0, a0, s0
+    xor a0, a0, s1
+    lw ra, 12(sp)
+    lw s0, 8(sp)
+    lw s1, 4(sp)
+    addi sp, sp, 16
+    ret
+
+# fib(a0)
+fib:
+    li t0, 2
+    blt a0, t0, .Lfib_return
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    sw s0, 8(sp)
+    sw s1, 4(sp)
+    mv s0, a0
+    addi a0, a0, -1
+    jal ra, fib
+    mv s1, a0
+    addi a0, s0, -2
+    jal ra, fib
+    add a0, a0, s1
+    lw ra, 12(sp)
+    lw s0, 8(sp)
+    lw s1, 4(sp)
+    addi sp, sp, 16
+.Lfib_return:
+    ret
+
+# hanoi(a0 = 层数)，返回移动次数
+hanoi:
+    beqz a0, .Lhanoi_return
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    sw s0, 8(sp)
+    sw s1, 4(sp)
+    addi s0, a0, -1
+    mv a0, s0
+    jal ra, hanoi
+    mv s1, a0
+    mv a0, s0
+    jal ra, hanoi
+    add a0, a0, s1
+    addi a0, a0, 1
+    lw ra, 12(sp)
+    lw s0, 8(sp)
+    lw s1, 4(sp)
+    addi sp, sp, 16
+.Lhanoi_return:
+    ret
+
+# ackermann(a0 = m, a1 = n)
+ackermann:
+    bnez a0, .Lack_m
+    addi a0, a1, 1
+    ret
+.Lack_m:
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    sw s0, 8(sp)
+    mv s0, a0
+    bnez a1, .Lack_n
+    addi a0, s0, -1
+    li a1, 1
+    jal ra, ackermann
+    j .Lack_done
+.Lack_n:
+    addi a1, a1, -1
+    jal ra, ackermann           # A(m, n-1)
+    mv a1, a0
+    addi a0, s0, -1
+    jal ra, ackermann           # A(m-1, A(m, n-1))
+.Lack_done:
+    lw ra, 12(sp)
+    lw s0, 8(sp)
+    addi sp, sp, 16
+    ret
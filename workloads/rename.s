@@ -0,0 +1,88 @@
+# 重命名消除：128轮，每轮用各种复制写法（mv、add/or/xor/sub与x0、c.mv）轮换寄存器，
+# 复制尚未算出的乘除法结果，用各种常数写法（li、ori/xori与x0、xor/sub rd, rs, rs、c.li）
+# 清零与置数，并在交替方向的分支两侧都放置复制，错误预测时须恢复映射。
+# prf配置下这些指令在重命名时消除，结果与其他配置相同
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+    .equ ROUNDS, 128
+main:
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    li s0, 0                    # 校验和
+    li s1, 0                    # 轮数
+    li a0, 1
+    li a1, 1
+    li a2, 0x9E3779B9
+
+.Lround:
+    # 类Fibonacci的轮换：a0, a1, a2 <- a1, a2, a0 + a1 ^ a2
+    add t0, a0, a1
+    xor t0, t0, a2
+    mv a0, a1
+    add a1, a2, zero
+    or a2, zero, t0
+    xor t1, a0, zero
+    sub t2, a1, zero
+    add s0, s0, t1
+    xor s0, s0, t2
+
+    # 复制乘除法的结果：源指令尚未写回时复制已经完成重命名
+    mul t3, a2, a1
+    mv t4, t3
+    divu t5, a2, a1
+    mv t6, t5
+    mv t5, t4                   # 覆盖仍被t6引用的物理寄存器的映射
+    add s0, s0, t6
+    xor s0, s0, t5
+
+    # 常数写法
+    li t0, 1234
+    ori t1, zero, 0x5a5
+    xori t2, zero, -1
+    xor t3, a2, a2
+    sub t4, a1, a1
+    add t5, zero, zero
+    add t0, t0, t1
+    xor t0, t0, t2
+    add t0, t0, t3
+    add t0, t0, t4
+    add t0, t0, t5
+    add s0, s0, t0
+
+    # 交替方向的分支，两侧都有复制与常数
+    andi t0, s1, 1
+    beqz t0, .Leven
+    mv t1, a0
+    li t2, 3
+    j .Ljoin
+.Leven:
+    mv t1, a1
+    li t2, 5
+.Ljoin:
+    mul t1, t1, t2
+    xor s0, s0, t1
+
+    .option push
+    .option rvc
+    c.mv a3, a2
+    c.li a4, 7
+    c.add a3, a4
+    c.mv a5, a3
+    .option pop
+    add s0, s0, a5
+    slli t0, s0, 3
+    srli s0, s0, 29
+    or s0, s0, t0
+
+    addi s1, s1, 1
+    li t0, ROUNDS
+    blt s1, t0, .Lround
+
+    mv a0, s0
+    lw ra, 12(sp)
+    addi sp, sp, 16
+    ret
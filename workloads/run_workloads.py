@@ -0,0 +1,225 @@
+#!/usr/bin/env python3
+"""在每种核配置上运行 workloads/ 下的全部程序，与 expected.txt 中的结果和基线比较。
+
+用法：workloads/run_workloads.py <模拟器可执行文件> [--tolerance 百分比] [--update]
+
+每次运行都打开差分检查。x10或指令数不一致视为错误；周期数比基线多出超过容差视为性能回退，
+少于基线超过容差时提示更新基线。--update 用本次结果重写 expected.txt。
+CHECKPOINT_AT 中的程序另外在给定周期保存检查点并恢复运行，结果须与直接运行完全相同，
+其中 SAMPLED 中的程序还从同一检查点恢复做采样模拟，输出的结果须与直接运行相同；
+HARTS 中的程序另外以多核重复运行，每次的x10都须与单核结果相同。这两项只支持base配置。
+FUSION 中的程序另外在每种配置上打开 --fusion 运行，x10须相同，各类融合次数须与表中一致；
+ELIMINATION 中的程序在prf配置上消除的复制与常数指令数须与表中一致。
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+EXPECTED = os.path.join(HERE, "expected.txt")
+CORES = ("base", "medium", "large", "prf")
+STATS = re.compile(r"Stats: x10 = 0x([0-9a-f]+), (\d+) cycles, (\d+) instructions")
+ELIMINATED = re.compile(r"Rename elimination: (\d+) moves, (\d+) constants")
+FUSED = re.compile(r"Fusion: (\d+) lui\+addi, (\d+) auipc\+jalr, (\d+) slli\+srli")
+
+# 做检查点往返的程序及保存检查点的周期：timer应落在等待定时器的期间，qsort落在流水线中间
+CHECKPOINT_AT = {"timer": 4000, "qsort": 3001}
+
+# 从检查点恢复后再做采样模拟的程序及采样间隔、窗口；功能模型下mtime不前进，不能有定时器
+SAMPLED = {"qsort": (2000, 500)}
+
+# 多核运行的程序及hart数；hart间的交错随线程调度变化，重复运行以暴露数据竞争
+HARTS = {"harts": (2, 4)}
+HART_RUNS = 3
+
+# 打开 --fusion 运行的程序及融合的lui+addi、auipc+jalr、slli+srli对数
+FUSION = {"fuse": (257, 64, 192)}
+
+# prf配置下重命名时消除的复制、常数指令数
+ELIMINATION = {"rename": (1409, 1156)}
+
+
+def read_expected():
+    expected = {}
+    with open(EXPECTED) as f:
+        for line in f:
+            line = line.split("#", 1)[0].split()
+            if line:
+                name, core, x10, cycles, instructions = line
+                expected[name, core] = (int(x10, 16), int(cycles), int(instructions))
+    return expected
+
+
+def write_expected(results):
+    with open(EXPECTED, "w") as f:
+        f.write("# 各核配置在默认选项下的结果与基线，由 run_workloads.py --update 生成\n")
+        f.write("# 程序 核配置 x10 周期数 指令数\n")
+        for name, core in sorted(results, key=lambda key: (key[0], CORES.index(key[1]))):
+            x10, cycles, instructions = results[name, core]
+            f.write("%-12s %-8s 0x%08x %10d %10d\n" % (name, core, x10, cycles, instructions))
+
+
+def parse_stats(proc):
+    match = STATS.search(proc.stderr)
+    if proc.returncode != 0 or not match:
+        return None, proc.stderr.strip()
+    return (int(match.group(1), 16), int(match.group(2)), int(match.group(3))), ""
+
+
+def run(simulator, name, options=(), counters=None):
+    """运行并返回统计；给出counters时另外返回其在标准错误中匹配到的各项计数"""
+    with open(os.path.join(HERE, name + ".data")) as image:
+        proc = subprocess.run([simulator, "--stats", *options], stdin=image,
+                              capture_output=True, text=True, timeout=600)
+    if counters is None:
+        return parse_stats(proc)
+    result, error = parse_stats(proc)
+    match = counters.search(proc.stderr)
+    if result is None or not match:
+        return None, error or "no counters"
+    return (result, tuple(int(count) for count in match.groups())), ""
+
+
+def check_harts(simulator, name, x10):
+    """以多核重复运行，返回第一个与单核x10不同的结果说明，全部相同时返回None"""
+    for harts in HARTS[name]:
+        for _ in range(HART_RUNS):
+            result, error = run(simulator, name, ("--harts", str(harts)))
+            if result is None:
+                return "%d harts: %s" % (harts, error or "no stats")
+            if result[0] != x10:
+                return "%d harts: x10 = 0x%08x" % (harts, result[0])
+    return None
+
+
+def run_checkpoint(simulator, name, cycle):
+    """运行到cycle保存检查点，再从检查点恢复并打开差分检查运行到结束；
+    SAMPLED中的程序另外从同一检查点恢复做采样模拟。
+    返回恢复后的统计、采样模拟输出的结果（x10低8位，不做采样时为None）"""
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, name + ".ckpt")
+        with open(os.path.join(HERE, name + ".data")) as image:
+            proc = subprocess.run([simulator, "--checkpoint-at", str(cycle),
+                                   "--save-checkpoint", path], stdin=image,
+                                  capture_output=True, text=True, timeout=600)
+        if proc.returncode != 0 or not os.path.exists(path):
+            return None, None, proc.stderr.strip() or "no checkpoint"
+        proc = subprocess.run([simulator, "--stats", "--cosim", "--restore-checkpoint", path],
+                              stdin=subprocess.DEVNULL, capture_output=True, text=True,
+                              timeout=600)
+        restored, error = parse_stats(proc)
+        if restored is None or name not in SAMPLED:
+            return restored, None, error
+        interval, window = SAMPLED[name]
+        proc = subprocess.run([simulator, "--restore-checkpoint", path, "--sample-interval",
+                               str(interval), "--sample-window", str(window)],
+                              stdin=subprocess.DEVNULL, capture_output=True, text=True,
+                              timeout=600)
+        if proc.returncode != 0 or not proc.stdout.split():
+            return restored, -1, proc.stderr.strip() or "sampling: no result"
+        return restored, int(proc.stdout.split()[-1]), ""
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("simulator")
+    parser.add_argument("--tolerance", type=float, default=2.0,
+                        help="allowed cycle change in percent (2.0)")
+    parser.add_argument("--update", action="store_true", help="rewrite expected.txt")
+    args = parser.parse_args()
+
+    names = sorted(f[:-5] for f in os.listdir(HERE) if f.endswith(".data"))
+    expected = {} if args.update else read_expected()
+    results = {}
+    failed = 0
+    for name in names:
+        for core in CORES:
+            label = "%-12s %-8s" % (name, core)
+            result, error = run(args.simulator, name, ("--core", core, "--cosim"))
+            if result is None:
+                print("%s FAIL     %s" % (label, error or "no stats"))
+                failed += 1
+                continue
+            if core == "base" and name in CHECKPOINT_AT:
+                restored, sampled, error = run_checkpoint(args.simulator, name,
+                                                          CHECKPOINT_AT[name])
+                if restored != result:
+                    print("%s FAIL     checkpoint at cycle %d: %s" % (
+                        label, CHECKPOINT_AT[name], error or "x10 = 0x%08x, %d cycles, "
+                        "%d instructions after restore" % restored))
+                    failed += 1
+                    continue
+                if sampled is not None and sampled != result[0] & 0xFF:
+                    print("%s FAIL     sampling from checkpoint at cycle %d: %s" % (
+                        label, CHECKPOINT_AT[name], error or "result %d, expected %d" % (
+                            sampled, result[0] & 0xFF)))
+                    failed += 1
+                    continue
+            if core == "base" and name in HARTS:
+                error = check_harts(args.simulator, name, result[0])
+                if error:
+                    print("%s FAIL     %s" % (label, error))
+                    failed += 1
+                    continue
+            if name in FUSION:
+                fused, error = run(args.simulator, name, ("--core", core, "--fusion", "--cosim"),
+                                   FUSED)
+                if fused is None or fused[0][0] != result[0] or fused[1] != FUSION[name]:
+                    print("%s FAIL     --fusion: %s" % (label, error or "x10 = 0x%08x, "
+                          "%d lui+addi, %d auipc+jalr, %d slli+srli, expected %s" % (
+                              fused[0][0], *fused[1], FUSION[name])))
+                    failed += 1
+                    continue
+            if core == "prf" and name in ELIMINATION:
+                eliminated, error = run(args.simulator, name, ("--core", core), ELIMINATED)
+                if eliminated is None or eliminated[1] != ELIMINATION[name]:
+                    print("%s FAIL     %s" % (label, error or "%d moves, %d constants eliminated, "
+                          "expected %s" % (*eliminated[1], ELIMINATION[name])))
+                    failed += 1
+                    continue
+            results[name, core] = result
+            x10, cycles, instructions = result
+            if args.update:
+                print("%s %10d cycles %10d instructions" % (label, cycles, instructions))
+                continue
+            if (name, core) not in expected:
+                print("%s NEW      no baseline, run with --update" % label)
+                continue
+            want_x10, want_cycles, want_instructions = expected[name, core]
+            change = 100.0 * (cycles - want_cycles) / want_cycles
+            detail = "%10d cycles (%+.2f%%) %10d instructions" % (cycles, change, instructions)
+            if x10 != want_x10:
+                status = "WRONG"
+                detail = "x10 = 0x%08x, expected 0x%08x" % (x10, want_x10)
+            elif instructions != want_instructions:
+                status = "WRONG"
+                detail = "%d instructions, expected %d" % (instructions, want_instructions)
+            elif change > args.tolerance:
+                status = "SLOWER"
+            elif change < -args.tolerance:
+                status = "FASTER"
+            else:
+                status = "ok"
+            if status in ("WRONG", "SLOWER"):
+                failed += 1
+            print("%s %-8s %s" % (label, status, detail))
+
+    for name, core in sorted(set(expected) - set(results)):
+        if name not in names:
+            print("%-12s %-8s MISSING  %s.data not found" % (name, core, name))
+            failed += 1
+
+    if args.update:
+        write_expected(results)
+    elif any(key in expected and results[key][1] < expected[key][1] * (1 - args.tolerance / 100)
+             for key in results):
+        print("cycles improved beyond tolerance, consider --update")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,126 @@
+# RV32C：用 .option rvc 让汇编器尽量生成压缩指令，16位与32位指令混排，32位指令常跨4字节边界。
+# 对128个元素做插入排序，每轮经c.jal调用的函数计算加权校验和，用栈上的局部变量
+# （c.lwsp/c.swsp）与c.jalr间接调用累加结果；末尾执行c.ebreak，由处理程序跳过
+    .option rvc
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+    .equ COUNT, 128
+main:
+    c.addi16sp sp, -32
+    c.swsp ra, 28(sp)
+    la t0, trap_handler
+    csrw mtvec, t0
+    li s0, 0x10000              # 数组
+    c.li s1, 0                  # 校验和
+    c.lui a5, 0x12
+    c.addi a5, 13               # xorshift状态
+    c.li a0, 0
+.Lfill:
+    c.mv a1, a5
+    c.slli a1, 13
+    c.xor a5, a1
+    c.mv a1, a5
+    c.srli a1, 17
+    c.xor a5, a1
+    c.mv a1, a5
+    c.slli a1, 5
+    c.xor a5, a1
+    c.mv a2, a5
+    c.srai a2, 8                # 带符号的元素
+    c.mv a3, a0
+    c.slli a3, 2
+    c.add a3, s0
+    c.sw a2, 0(a3)
+    c.addi a0, 1
+    li a4, COUNT
+    blt a0, a4, .Lfill
+
+    # 插入排序：每插入一个元素调用一次checksum
+    c.li a0, 1
+.Lsort:
+    c.mv a3, a0
+    c.slli a3, 2
+    c.add a3, s0
+    c.lw a2, 0(a3)              # 待插入的元素
+    c.mv a4, a0
+.Lshift:
+    c.beqz a4, .Linsert
+    lw a1, -4(a3)
+    bge a2, a1, .Linsert
+    c.sw a1, 0(a3)
+    c.addi a3, -4
+    c.addi a4, -1
+    c.j .Lshift
+.Linsert:
+    c.sw a2, 0(a3)
+    c.swsp a0, 12(sp)
+    c.jal checksum
+    c.lwsp a0, 12(sp)
+    c.addi a0, 1
+    li a4, COUNT
+    blt a0, a4, .Lsort
+
+    # 有序性检查：逆序对个数计入校验和
+    c.li a0, 0
+    c.li a4, 0
+.Lcheck:
+    c.mv a3, a0
+    c.slli a3, 2
+    c.add a3, s0
+    c.lw a1, 0(a3)
+    c.lw a2, 4(a3)
+    slt a2, a2, a1
+    c.add a4, a2
+    c.addi a0, 1
+    li a2, COUNT - 1
+    blt a0, a2, .Lcheck
+    c.slli a4, 24
+    c.xor s1, a4
+
+    # c.jalr经寄存器调用，c.addi4spn取栈上地址
+    la a5, checksum
+    c.jalr a5
+    c.addi4spn a1, sp, 16
+    c.sw s1, 0(a1)
+    c.lwsp a0, 16(sp)
+    c.ebreak
+    c.nop
+    c.lwsp ra, 28(sp)
+    c.addi16sp sp, 32
+    c.jr ra
+
+# s1 = s1 * 33 ^ sum(a[i] * (i & 7))，只使用a1~a5与t0
+checksum:
+    c.li a1, 0
+    c.li a2, 0
+.Lsum:
+    c.mv a3, a1
+    c.slli a3, 2
+    c.add a3, s0
+    c.lw a4, 0(a3)
+    c.mv a3, a1
+    c.andi a3, 7
+    mul a4, a4, a3
+    c.add a2, a4
+    c.addi a1, 1
+    li t0, COUNT
+    blt a1, t0, .Lsum
+    c.mv a3, s1
+    c.slli a3, 5
+    c.add s1, a3
+    c.xor s1, a2
+    c.jr ra
+
+# c.ebreak：累加mcause，跳过2字节
+    .p2align 2
+trap_handler:
+    csrr t5, mcause
+    c.add s1, t5
+    csrr t6, mepc
+    c.addi t6, 2
+    csrw mepc, t6
+    mret
@@ -0,0 +1,143 @@
+# 字符串处理：strlen、单词计数、转大写复制、原地反转、子串查找与多项式散列，重复8遍
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+main:
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    sw s0, 8(sp)
+    sw s1, 4(sp)
+    li s0, 0                    # 累积结果
+    li s1, 8
+.Lround:
+    jal ra, process
+    slli t0, s0, 5
+    add s0, s0, t0
+    add s0, s0, a0              # s = s * 33 + r
+    addi s1, s1, -1
+    bnez s1, .Lround
+    mv a0, s0
+    lw ra, 12(sp)
+    lw s0, 8(sp)
+    lw s1, 4(sp)
+    addi sp, sp, 16
+    ret
+
+# 处理一遍text，返回 hash ^ (words << 8) ^ (len << 20) ^ (matches << 12)
+process:
+    la a0, text
+
+    # strlen
+    mv t0, a0
+.Lstrlen:
+    lbu t1, 0(t0)
+    addi t0, t0, 1
+    bnez t1, .Lstrlen
+    sub a1, t0, a0
+    addi a1, a1, -1             # 长度
+
+    # 单词计数：非空格字符前面是空格或开头
+    li a2, 0
+    li t2, 1                    # 前一个字符是空格
+    mv t0, a0
+.Lwords:
+    lbu t1, 0(t0)
+    beqz t1, .Lwords_done
+    addi t3, t1, -32
+    seqz t3, t3                 # 当前是空格
+    bnez t3, .Lwords_next
+    add a2, a2, t2
+.Lwords_next:
+    mv t2, t3
+    addi t0, t0, 1
+    j .Lwords
+.Lwords_done:
+
+    # 转大写复制到buffer
+    li a3, 0x10000
+    mv t0, a0
+    mv t4, a3
+    li t5, 26
+.Lupper:
+    lbu t1, 0(t0)
+    addi t3, t1, -97
+    bgeu t3, t5, .Lupper_store
+    addi t1, t1, -32
+.Lupper_store:
+    sb t1, 0(t4)
+    addi t0, t0, 1
+    addi t4, t4, 1
+    bnez t1, .Lupper
+
+    # 原地反转
+    mv t0, a3
+    add t4, a3, a1
+    addi t4, t4, -1
+.Lreverse:
+    bgeu t0, t4, .Lreverse_done
+    lbu t1, 0(t0)
+    lbu t2, 0(t4)
+    sb t2, 0(t0)
+    sb t1, 0(t4)
+    addi t0, t0, 1
+    addi t4, t4, -1
+    j .Lreverse
+.Lreverse_done:
+
+    # 朴素子串查找，统计 "the" 在原文中的出现次数
+    li a4, 0
+    la t6, pattern
+    mv t0, a0
+.Lsearch:
+    lbu t1, 0(t0)
+    beqz t1, .Lsearch_done
+    mv t2, t0
+    mv t3, t6
+.Lmatch:
+    lbu t5, 0(t3)
+    beqz t5, .Lfound
+    lbu t1, 0(t2)
+    bne t1, t5, .Lsearch_next
+    addi t2, t2, 1
+    addi t3, t3, 1
+    j .Lmatch
+.Lfound:
+    addi a4, a4, 1
+.Lsearch_next:
+    addi t0, t0, 1
+    j .Lsearch
+.Lsearch_done:
+
+    # 反转后的大写串做 h = h * 31 + c
+    li a5, 0
+    li t5, 31
+    mv t0, a3
+.Lhash:
+    lbu t1, 0(t0)
+    beqz t1, .Lhash_done
+    mul a5, a5, t5
+    add a5, a5, t1
+    addi t0, t0, 1
+    j .Lhash
+.Lhash_done:
+
+    slli a2, a2, 8
+    slli a1, a1, 20
+    slli a4, a4, 12
+    xor a0, a5, a2
+    xor a0, a0, a1
+    xor a0, a0, a4
+    ret
+
+pattern:
+    .asciz "the"
+text:
+    .ascii "the quick brown fox jumps over the lazy dog while the other dogs "
+    .ascii "watch from the shade of the old oak tree near the river bank and "
+    .ascii "nobody in the village remembers when the tree was planted or who "
+    .ascii "planted it there but everyone agrees that the shade is pleasant "
+    .ascii "on a hot summer afternoon when the sun is high and the air is still "
+    .asciz "and the only sound is the water moving slowly past the stones"
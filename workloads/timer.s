@@ -0,0 +1,94 @@
+# 定时器与软件中断：按mtime设置mtimecmp后WFI等待，共16次定时器中断与4次软件中断，
+# 每次等待之间做一段整数运算；中断在打开mstatus.MIE时才响应，各配置下指令数相同
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+main:
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    la t0, trap_handler
+    csrw mtvec, t0
+    li s0, 0x02004000           # hart 0的mtimecmp
+    li s1, 0x0200BFF8           # mtime
+    li s2, 0                    # 定时器中断次数
+    li s3, 0                    # 软件中断次数
+    li s4, 0                    # mcause累加
+    li s5, 0x9E3779B9           # 运算状态
+    li t0, 0x88                 # MTIE | MSIE
+    csrw mie, t0
+
+.Ltimer:
+    # mtimecmp = mtime + 400：先把低字写为全1，避免写入过程中出现较早的比较值
+    lw t1, 0(s1)
+    addi t1, t1, 400
+    li t2, -1
+    sw t2, 0(s0)
+    sw zero, 4(s0)
+    sw t1, 0(s0)
+    jal ra, work
+    wfi
+    csrsi mstatus, 8
+    csrci mstatus, 8
+    li t0, 16
+    blt s2, t0, .Ltimer
+
+.Lsoftware:
+    li t1, 0x02000000           # hart 0的msip
+    li t2, 1
+    sw t2, 0(t1)
+    csrsi mstatus, 8
+    csrci mstatus, 8
+    jal ra, work
+    li t0, 4
+    blt s3, t0, .Lsoftware
+
+    # a0 = 定时器次数 << 24 ^ 软件中断次数 << 16 ^ mcause累加 << 8 ^ 运算状态
+    slli a0, s2, 24
+    slli t0, s3, 16
+    xor a0, a0, t0
+    slli t0, s4, 8
+    xor a0, a0, t0
+    xor a0, a0, s5
+    lw ra, 12(sp)
+    addi sp, sp, 16
+    ret
+
+# 32轮xorshift，更新s5
+work:
+    li t0, 32
+.Lwork:
+    slli t1, s5, 13
+    xor s5, s5, t1
+    srli t1, s5, 17
+    xor s5, s5, t1
+    slli t1, s5, 5
+    xor s5, s5, t1
+    addi t0, t0, -1
+    bnez t0, .Lwork
+    ret
+
+# 只使用t5、t6；定时器中断关闭定时器，软件中断清除msip
+    .p2align 2
+trap_handler:
+    csrr t5, mcause
+    bgez t5, .Lunexpected
+    andi t5, t5, 0xff
+    add s4, s4, t5
+    li t6, 7
+    bne t5, t6, .Lsoft
+    addi s2, s2, 1
+    li t6, -1
+    sw t6, 0(s0)
+    sw t6, 4(s0)
+    mret
+.Lsoft:
+    li t6, 0x02000000
+    sw zero, 0(t6)
+    addi s3, s3, 1
+    mret
+.Lunexpected:
+    li a0, -1
+    .word 0x0ff00513
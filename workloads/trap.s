@@ -0,0 +1,90 @@
+# 同步异常：32轮，每轮依次触发EBREAK、陷入模式下的ECALL、非映射地址的Load与Store，
+# 另有一条只在错误预测路径上执行的非映射Load，不应陷入。处理程序累加mcause、mepc与mtval，
+# 按指令长度跳过引发异常的指令；返回异常次数与累加结果的组合
+    .text
+_start:
+    lui sp, 0x20
+    jal ra, main
+    .word 0x0ff00513            # 停机
+
+    .equ ROUNDS, 32
+main:
+    addi sp, sp, -16
+    sw ra, 12(sp)
+    la t0, trap_handler
+    csrw mtvec, t0
+    li s0, 0                    # 异常次数
+    li s1, 0                    # mcause累加
+    li s2, 0                    # mepc、mtval的校验和
+    li s3, 0x40000000           # 非映射地址
+    li s4, 0                    # 轮数
+    li s5, 0x9E3779B9           # 运算状态
+
+.Lround:
+    ebreak
+    addi s5, s5, 1
+    li a7, 93                   # 设置了mtvec，不会当作exit执行
+    ecall
+    slli t0, s4, 2
+    add t0, s3, t0
+    lw t1, 0(t0)
+    xor s5, s5, t1              # 引发异常的Load不写回，t1保持原值
+    sw s5, 4(t0)
+    # 偶数轮第一条分支跳过；奇数轮第二条分支总会跳转，非映射Load只在错误预测的路径上执行
+    andi t2, s4, 1
+    beqz t2, .Lnext
+    bnez t2, .Lnext
+    lw t1, 8(s3)
+.Lnext:
+    slli t1, s5, 5
+    xor s5, s5, t1
+    srli t1, s5, 7
+    xor s5, s5, t1
+    addi s4, s4, 1
+    li t0, ROUNDS
+    blt s4, t0, .Lround
+
+    # 关闭陷入后ECALL恢复为系统调用：brk(0)返回堆顶，非零即成功
+    csrw mtvec, zero
+    li a0, 0
+    li a7, 214
+    ecall
+    snez t0, a0
+
+    # a0 = 异常次数 << 24 ^ mcause累加 << 12 ^ 校验和 ^ 运算状态 ^ brk结果
+    slli a0, s0, 24
+    slli t1, s1, 12
+    xor a0, a0, t1
+    xor a0, a0, s2
+    xor a0, a0, s5
+    xor a0, a0, t0
+    lw ra, 12(sp)
+    addi sp, sp, 16
+    ret
+
+# 只使用t3~t6与s0~s2
+    .p2align 2
+trap_handler:
+    csrr t3, mcause
+    bltz t3, .Lunexpected
+    add s1, s1, t3
+    addi s0, s0, 1
+    csrr t4, mepc
+    csrr t5, mtval
+    slli t6, s2, 3
+    srli s2, s2, 29
+    or s2, s2, t6
+    xor s2, s2, t4
+    add s2, s2, t5
+    lhu t6, 0(t4)
+    andi t6, t6, 3
+    li t3, 3
+    addi t4, t4, 2
+    bne t6, t3, .Lresume
+    addi t4, t4, 2
+.Lresume:
+    csrw mepc, t4
+    mret
+.Lunexpected:
+    li a0, -1
+    .word 0x0ff00513